@@ -28,8 +28,9 @@ static void DebugLog(const std::string&) {}
 // ============================================================================
 // Auto-find model in ONNX_models/ subfolder next to the plugin
 // ============================================================================
-// variant: "x" for best quality, "m" for faster
-static std::string FindDefaultModel(const char* variant = "x") {
+// variant: "x" for best quality, "m" for faster. quantized picks among the
+// INT8 models (YoloEngine::IsQuantizedModel) instead of the float ones.
+static std::string FindDefaultModel(const char* variant = "x", bool quantized = false) {
     // Build a variant-specific search token, e.g. "26x" or "26m"
     std::string varToken = std::string("26") + variant;
 
@@ -63,6 +64,7 @@ static std::string FindDefaultModel(const char* variant = "x") {
         int narrowLen = WideCharToMultiByte(CP_UTF8, 0, fname.c_str(), -1, NULL, 0, NULL, NULL);
         std::string narrowName(narrowLen - 1, '\0');
         WideCharToMultiByte(CP_UTF8, 0, fname.c_str(), -1, &narrowName[0], narrowLen, NULL, NULL);
+        if (YoloEngine::IsQuantizedModel(narrowName.c_str()) != quantized) continue;
 
         if (narrowName.find(varToken) != std::string::npos) {
             bestMatch = searchDir + fname;
@@ -99,7 +101,8 @@ static std::string FindDefaultModel(const char* variant = "x") {
     struct dirent* ep;
     while ((ep = readdir(dp))) {
         std::string name = ep->d_name;
-        if (name.size() > 5 && name.substr(name.size() - 5) == ".onnx") {
+        if (name.size() > 5 && name.substr(name.size() - 5) == ".onnx" &&
+            YoloEngine::IsQuantizedModel(name.c_str()) == quantized) {
             if (name.find(varToken) != std::string::npos &&
                 name.find("pose") != std::string::npos) {
                 bestMatch = modelsDir + name;
@@ -116,6 +119,23 @@ static std::string FindDefaultModel(const char* variant = "x") {
 #endif
 }
 
+// Model for a Model Quality popup value. INT8 prefers the quantized x model,
+// then any quantized model, and falls back to Best Quality if none is left.
+static std::string ModelForQuality(A_long quality) {
+    if (quality == MODEL_QUALITY_INT8) {
+        std::string model = FindDefaultModel("x", true);
+        if (!model.empty()) return model;
+    }
+    return FindDefaultModel(quality == MODEL_QUALITY_FASTER ? "m" : "x");
+}
+
+// Start loading the model the Model Quality / Use GPU params select on a
+// background thread, so Analyze finds it resident and warmed up.
+static void PreloadSelectedModel(A_long quality, bool use_gpu) {
+    std::string model = ModelForQuality(quality);
+    if (!model.empty()) YoloEngine::Backend().PreloadSession(model.c_str(), use_gpu);
+}
+
 // ============================================================================
 // About
 // ============================================================================
@@ -162,7 +182,7 @@ static PF_Err GlobalSetdown(PF_InData* in_data, PF_OutData* out_data,
 }
 
 // ============================================================================
-// ParamsSetup — 43 parameters
+// ParamsSetup — 45 parameters
 // ============================================================================
 static PF_Err ParamsSetup(PF_InData* in_data, PF_OutData* out_data,
                            PF_ParamDef* params[], PF_LayerDef* output) {
@@ -174,13 +194,19 @@ static PF_Err ParamsSetup(PF_InData* in_data, PF_OutData* out_data,
     PF_ADD_BUTTON("Analyze", "Analyze",
                   0, PF_ParamFlag_SUPERVISE, ANALYZE_DISK_ID);
 
-    // Param 3: Model Quality popup
+    // Param 3: Model Quality popup (supervised: changes preload the model).
+    // Always three choices, so a project saved with INT8 stays in range on a
+    // machine without a quantized model; there the entry is disabled ("("
+    // prefix) and Analyze falls back to Best Quality with a message.
+    bool have_int8 = !FindDefaultModel("x", true).empty();
     AEFX_CLR_STRUCT(def);
-    PF_ADD_POPUP("Model Quality",
-                 2,                     // num choices
-                 MODEL_QUALITY_BEST,    // default = Best Quality
-                 "Best Quality (x)|Faster (m)",
-                 MODEL_QUALITY_DISK_ID);
+    PF_ADD_POPUPX("Model Quality",
+                  3,                     // num choices
+                  MODEL_QUALITY_BEST,    // default = Best Quality
+                  have_int8 ? "Best Quality (x)|Faster (m)|INT8 (CPU)"
+                            : "Best Quality (x)|Faster (m)|(INT8 (CPU) - no model installed",
+                  PF_ParamFlag_SUPERVISE,
+                  MODEL_QUALITY_DISK_ID);
 
     // Param 4: Confidence threshold
     AEFX_CLR_STRUCT(def);
@@ -189,10 +215,10 @@ static PF_Err ParamsSetup(PF_InData* in_data, PF_OutData* out_data,
                           PF_Precision_HUNDREDTHS, 0, 0,
                           CONFIDENCE_DISK_ID);
 
-    // Param 4: Use GPU checkbox
+    // Param 4: Use GPU checkbox (supervised: changes preload the model)
     AEFX_CLR_STRUCT(def);
     PF_ADD_CHECKBOXX("Use GPU (DirectML)",
-                     TRUE, 0, USE_GPU_DISK_ID);
+                     TRUE, PF_ParamFlag_SUPERVISE, USE_GPU_DISK_ID);
 
     // Param 5: SavGol smoothing window size (odd, 1 = no smoothing)
     AEFX_CLR_STRUCT(def);
@@ -215,6 +241,18 @@ static PF_Err ParamsSetup(PF_InData* in_data, PF_OutData* out_data,
                           PF_Precision_INTEGER, 0, 0,
                           SKIP_FRAMES_DISK_ID);
 
+    // Param 8: Render frames at full resolution (default: auto-downsample to
+    // just above the model input size)
+    AEFX_CLR_STRUCT(def);
+    PF_ADD_CHECKBOXX("Full Resolution Analysis",
+                     FALSE, 0, FULL_RES_DISK_ID);
+
+    // Param 9: Track subject — letterbox a crop around the previous frame's
+    // detection, falling back to the full frame when confidence drops
+    AEFX_CLR_STRUCT(def);
+    PF_ADD_CHECKBOXX("Track Subject (Crop)",
+                     FALSE, 0, TRACK_SUBJECT_DISK_ID);
+
     // Param 10: Group start - Keypoints
     AEFX_CLR_STRUCT(def);
     PF_ADD_TOPICX("Keypoints", PF_ParamFlag_START_COLLAPSED, GROUP_START_DISK_ID);
@@ -265,6 +303,11 @@ static PF_Err SequenceSetup(PF_InData* in_data, PF_OutData* out_data,
 
     out_data->sequence_data = h;
     DebugLog("SequenceSetup: created unflat sequence data");
+
+    // Effect just applied: warm up the default model. Params are at their
+    // defaults here (Best Quality, Use GPU on); a reopened project instead
+    // preloads what it saved, in SequenceResetup.
+    PreloadSelectedModel(MODEL_QUALITY_BEST, true);
     return err;
 }
 
@@ -292,6 +335,7 @@ static PF_Err SequenceFlatten(PF_InData* in_data, PF_OutData* out_data,
     memset(&flat, 0, sizeof(flat));
     flat.is_flat = TRUE;
     flat.has_model = seq->has_model;
+    flat.cpu_only = seq->cpu_only;
     memcpy(flat.model_path, seq->model_path, MAX_MODEL_PATH);
 
     PF_UNLOCK_HANDLE(in_data->sequence_data);
@@ -332,12 +376,17 @@ static PF_Err SequenceResetup(PF_InData* in_data, PF_OutData* out_data,
     memset(seq, 0, sizeof(UnflatSeqData));
     seq->is_flat = FALSE;
     seq->has_model = saved.has_model;
+    seq->cpu_only = saved.cpu_only;
     memcpy(seq->model_path, saved.model_path, MAX_MODEL_PATH);
     seq->model_input_size = 0;
     PF_UNLOCK_HANDLE(h);
 
     out_data->sequence_data = h;
     DebugLog("SequenceResetup: unflattened (model=" + std::string(saved.model_path) + ")");
+
+    // Project reopened: warm up the model and EP this instance last analyzed
+    // with, so the preload lands in the cache entry Analyze will look up.
+    if (saved.has_model) YoloEngine::Backend().PreloadSession(saved.model_path, !saved.cpu_only);
     return err;
 }
 
@@ -362,6 +411,7 @@ static PF_Err GetFlattenedSequenceData(PF_InData* in_data, PF_OutData* out_data,
     memset(flat, 0, sizeof(FlatSeqData));
     flat->is_flat = TRUE;
     flat->has_model = seq->has_model;
+    flat->cpu_only = seq->cpu_only;
     memcpy(flat->model_path, seq->model_path, MAX_MODEL_PATH);
     PF_UNLOCK_HANDLE(h);
 
@@ -378,6 +428,15 @@ static PF_Err UserChangedParam(PF_InData* in_data, PF_OutData* out_data,
                                 const PF_UserChangedParamExtra* which_hit) {
     PF_Err err = PF_Err_NONE;
 
+    if (which_hit->param_index == PARAM_MODEL_QUALITY ||
+        which_hit->param_index == PARAM_USE_GPU) {
+        // Load the newly selected variant/EP in the background; the session
+        // in use (and any analysis running on it) is untouched until Analyze.
+        PreloadSelectedModel(params[PARAM_MODEL_QUALITY]->u.pd.value,
+                             params[PARAM_USE_GPU]->u.bd.value != 0);
+        return err;
+    }
+
     if (which_hit->param_index == PARAM_ANALYZE_BUTTON) {
         DebugLog("UserChangedParam: Analyze button clicked");
 
@@ -391,21 +450,24 @@ static PF_Err UserChangedParam(PF_InData* in_data, PF_OutData* out_data,
         }
 
         // Read model quality dropdown
-        const char* variant = "x";  // default: Best Quality
+        A_long quality = MODEL_QUALITY_BEST;
         PF_ParamDef quality_param;
         AEFX_CLR_STRUCT(quality_param);
         if (!PF_CHECKOUT_PARAM(in_data, PARAM_MODEL_QUALITY,
                                 in_data->current_time, in_data->time_step,
                                 in_data->time_scale, &quality_param)) {
-            if (quality_param.u.pd.value == MODEL_QUALITY_FASTER) {
-                variant = "m";
-            }
+            quality = quality_param.u.pd.value;
             PF_CHECKIN_PARAM(in_data, &quality_param);
         }
 
+        // INT8 selected (e.g. in a project from another machine) but no
+        // quantized model here: ModelForQuality uses Best Quality instead.
+        bool int8_missing = quality == MODEL_QUALITY_INT8 &&
+                            FindDefaultModel("x", true).empty();
+
         // Auto-find model (always re-resolve based on quality dropdown)
         {
-            std::string defaultModel = FindDefaultModel(variant);
+            std::string defaultModel = ModelForQuality(quality);
             if (!defaultModel.empty()) {
                 strncpy(seq->model_path, defaultModel.c_str(), MAX_MODEL_PATH - 1);
                 seq->model_path[MAX_MODEL_PATH - 1] = '\0';
@@ -430,10 +492,11 @@ static PF_Err UserChangedParam(PF_InData* in_data, PF_OutData* out_data,
             ERR(PF_CHECKIN_PARAM(in_data, &gpu_param));
         }
 
-        YoloEngine::EnsureSession(seq->model_path, use_gpu);
+        seq->cpu_only = use_gpu ? FALSE : TRUE;
+        YoloEngine::Backend().EnsureSession(seq->model_path, use_gpu);
         PF_UNLOCK_HANDLE(in_data->sequence_data);
 
-        if (!YoloEngine::IsReady()) {
+        if (!YoloEngine::Backend().IsReady()) {
             DebugLog("UserChangedParam: model failed to load");
             return PF_Err_NONE;
         }
@@ -482,8 +545,39 @@ static PF_Err UserChangedParam(PF_InData* in_data, PF_OutData* out_data,
             PF_CHECKIN_PARAM(in_data, &sf_param);
         }
 
+        // Read full-resolution override
+        bool force_full_res = false;
+        PF_ParamDef fr_param;
+        AEFX_CLR_STRUCT(fr_param);
+        if (!PF_CHECKOUT_PARAM(in_data, PARAM_FULL_RES,
+                                in_data->current_time, in_data->time_step,
+                                in_data->time_scale, &fr_param)) {
+            force_full_res = fr_param.u.bd.value != 0;
+            PF_CHECKIN_PARAM(in_data, &fr_param);
+        }
+
+        // Read tracking crop mode
+        bool track_subject = false;
+        PF_ParamDef ts_param;
+        AEFX_CLR_STRUCT(ts_param);
+        if (!PF_CHECKOUT_PARAM(in_data, PARAM_TRACK_SUBJECT,
+                                in_data->current_time, in_data->time_step,
+                                in_data->time_scale, &ts_param)) {
+            track_subject = ts_param.u.bd.value != 0;
+            PF_CHECKIN_PARAM(in_data, &ts_param);
+        }
+
         // Run analysis
-        err = AnalyzeAndWriteKeyframes(in_data, out_data, conf_threshold, smooth_window, smooth_order, skip_frames);
+        err = AnalyzeAndWriteKeyframes(in_data, out_data, conf_threshold, smooth_window, smooth_order,
+                                       skip_frames, force_full_res, track_subject);
+
+        if (!err && int8_missing) {
+            DebugLog("UserChangedParam: no INT8 model installed, analyzed with Best Quality");
+            PF_SPRINTF(out_data->return_msg,
+                "Model Quality is set to INT8, but no *int8*.onnx model is installed in "
+                "ONNX_models/. The layer was analyzed with Best Quality (x) instead.");
+            out_data->out_flags |= PF_OutFlag_DISPLAY_ERROR_MESSAGE;
+        }
 
         out_data->out_flags |= PF_OutFlag_FORCE_RERENDER;
     }
@@ -56,25 +56,27 @@ static const char* const kKeypointNames[NUM_KEYPOINTS] = {
 };
 
 // ============================================================================
-// Parameter IDs — 44 total
+// Parameter IDs — 46 total
 // ============================================================================
 enum ParamID {
     PARAM_INPUT = 0,
     PARAM_ANALYZE_BUTTON,       // 1
-    PARAM_MODEL_QUALITY,        // 2 — popup: Best Quality (x) / Faster (m)
+    PARAM_MODEL_QUALITY,        // 2 — popup: Best Quality (x) / Faster (m) [/ INT8]
     PARAM_CONFIDENCE,           // 3
     PARAM_USE_GPU,              // 4
     PARAM_SMOOTH_WINDOW,        // 5 — SavGol window size (odd, 1=off)
     PARAM_SMOOTH_ORDER,         // 6 — SavGol polynomial order (1–5)
     PARAM_SKIP_FRAMES,          // 7 — detection stride (1=every frame, N=every Nth)
-    PARAM_GROUP_START,          // 8
+    PARAM_FULL_RES,             // 8 — render full-res frames instead of auto-downsampling
+    PARAM_TRACK_SUBJECT,        // 9 — letterbox a crop around the previous detection
+    PARAM_GROUP_START,          // 10
 
-    // 17 keypoints × 2 (Point, Conf) = 34 params, indices 9–42
-    PARAM_KP_FIRST = 9,
-    PARAM_KP_LAST  = 42,        // PARAM_KP_FIRST + NUM_KEYPOINTS * 2 - 1
+    // 17 keypoints × 2 (Point, Conf) = 34 params, indices 11–44
+    PARAM_KP_FIRST = 11,
+    PARAM_KP_LAST  = 44,        // PARAM_KP_FIRST + NUM_KEYPOINTS * 2 - 1
 
-    PARAM_GROUP_END,            // 43
-    PARAM_NUM_PARAMS            // 44
+    PARAM_GROUP_END,            // 45
+    PARAM_NUM_PARAMS            // 46
 };
 
 // Helper: get param index for keypoint k (0–16) position (Point2D)
@@ -96,10 +98,13 @@ inline PF_ParamIndex KP_CONF_PARAM(int k) {
 #define SMOOTH_ORDER_DISK_ID    7
 #define GROUP_START_DISK_ID     5
 #define SKIP_FRAMES_DISK_ID     10
+#define FULL_RES_DISK_ID        11
+#define TRACK_SUBJECT_DISK_ID   12
 
 // Model quality popup values (1-indexed for AE popups)
 #define MODEL_QUALITY_BEST      1   // yolo26x-pose (Best Quality)
 #define MODEL_QUALITY_FASTER    2   // yolo26m-pose (Faster)
+#define MODEL_QUALITY_INT8      3   // *int8*.onnx, disabled when none is installed
 // Keypoint disk IDs: Point = 100 + k*2, Conf = 100 + k*2 + 1
 #define KP_POINT_DISK_ID(k)    (100 + (k) * 2)
 #define KP_CONF_DISK_ID(k)     (100 + (k) * 2 + 1)
@@ -111,14 +116,16 @@ inline PF_ParamIndex KP_CONF_PARAM(int k) {
 struct FlatSeqData {
     A_Boolean   is_flat;
     A_Boolean   has_model;
-    A_u_short   padding;
+    A_Boolean   cpu_only;       // Use GPU was off for the model; was padding, so old projects read 0 (GPU)
+    A_u_char    padding;
     char        model_path[MAX_MODEL_PATH];
 };
 
 struct UnflatSeqData {
     A_Boolean   is_flat;
     A_Boolean   has_model;
-    A_u_short   padding;
+    A_Boolean   cpu_only;       // Use GPU was off for the model; was padding, so old projects read 0 (GPU)
+    A_u_char    padding;
     char        model_path[MAX_MODEL_PATH];
     int         model_input_size;   // auto-detected, typically 640
 };
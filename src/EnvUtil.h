@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdlib>
+
+// Environment overrides shared by the engine and the analyzer (header-only).
+// An empty variable counts as unset.
+
+// Integer tuning override from the environment (used on render nodes), or
+// fallback when unset.
+inline int GetEnvInt(const char* name, int fallback) {
+    const char* value = std::getenv(name);
+    if (!value || !*value) return fallback;
+    return std::atoi(value);
+}
+
+inline bool IsEnvSet(const char* name) {
+    const char* value = std::getenv(name);
+    return value && *value;
+}
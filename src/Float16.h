@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+#include "onnxruntime_float16.h"
+
+// IEEE half for FP16 model inputs and outputs. Same bits and conversions as
+// Ort::Float16_t (both build on onnxruntime_float16::Float16Impl), but usable
+// without the ORT C++ API, so Letterbox and YoloPostprocess stay ORT-free and
+// the engine can reinterpret one as the other.
+struct Float16 : onnxruntime_float16::Float16Impl<Float16> {
+    Float16() = default;
+    explicit Float16(float v) noexcept { val = ToUint16Impl(v); }
+
+    static constexpr Float16 FromBits(uint16_t bits) noexcept {
+        Float16 h;
+        h.val = bits;
+        return h;
+    }
+
+    float ToFloat() const noexcept { return ToFloatImpl(); }
+    explicit operator float() const noexcept { return ToFloatImpl(); }
+};
+
+static_assert(sizeof(Float16) == sizeof(uint16_t), "Float16 must be exactly two bytes");
+
+// Element widening for code templated on the tensor element type.
+inline float ToFloat(float v) { return v; }
+inline float ToFloat(Float16 v) { return v.ToFloat(); }
@@ -3,12 +3,18 @@
 #include "YoloPostprocess.h"
 #include "Letterbox.h"
 #include "SavGolSmooth.h"
+#include "EnvUtil.h"
 
 #include "AEGP_SuiteHandler.h"
 #include "AE_GeneralPlug.h"
 
 #include <vector>
 #include <string>
+#include <cstdlib>
+#include <type_traits>
+#include <future>
+#include <atomic>
+#include <chrono>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -26,13 +32,39 @@ static void DebugLog(const std::string&) {}
 
 static AEGP_PluginID g_aegp_plugin_id = 0;
 
+// Tracking crop tuning. A crop is only trusted while the subject stays
+// confidently detected; anything weaker re-runs the frame uncropped.
+static const float kTrackMinConf     = 0.5f;  // min box confidence to keep tracking
+static const int   kTrackCropQuantum = 32;    // crop size step (px) so plans are reused
+static const int   kMinCropInput     = 320;   // smallest input for dynamic-shape models
+
+// YOLO's total downsampling; dynamic-shape inputs must be multiples of it.
+static const int   kModelStride      = 32;
+
+// How often the progress dialog is polled for Cancel while a frame's
+// inference runs on a worker thread.
+static const int   kCancelPollMs     = 100;
+
+// Detections from the last cancelled Analyze. Running Analyze again on the
+// same layer with the same settings and model picks up where it stopped
+// instead of re-rendering finished frames. `key` identifies the run.
+struct AnalysisCheckpoint {
+    std::string                 key;
+    std::vector<KeypointResult> results;
+    std::vector<bool>           valid;
+    std::vector<bool>           done;
+};
+static AnalysisCheckpoint g_checkpoint;
+
 PF_Err AnalyzeAndWriteKeyframes(
     PF_InData* in_data,
     PF_OutData* out_data,
     float conf_threshold,
     int smooth_window,
     int smooth_order,
-    int skip_frames)
+    int skip_frames,
+    bool force_full_res,
+    bool track_subject)
 {
     PF_Err err = PF_Err_NONE;
 
@@ -178,21 +210,97 @@ PF_Err AnalyzeAndWriteKeyframes(
     }
 
     // --- 5. Check model is loaded ---
-    if (!YoloEngine::IsReady()) {
+    // Pinned so the idle unload cannot take the session away mid-analysis.
+    InferenceBackend& engine = YoloEngine::Backend();
+    BackendPin session_pin(engine);
+    if (!engine.IsReady()) {
         DebugLog("Model not loaded, aborting");
         suites.EffectSuite4()->AEGP_DisposeEffect(effectRefH);
         return PF_Err_NONE;
     }
 
-    int input_size = YoloEngine::GetInputSize();
+    int input_size = engine.GetInputSize();
     DebugLog("Step 5: Model ready, input_size=" + std::to_string(input_size));
 
+    // --- 5b. Pick the render downsample factor ---
+    // Letterboxing keeps only input_size pixels along the long side, so a 4K
+    // layer rendered at full res throws away >90% of what AE just rendered.
+    // Render at the largest factor that still covers the model input and scale
+    // the letterbox info back up so keyframes stay in full-res layer space.
+    int src_w = 0, src_h = 0;
+    {
+        AEGP_ItemH srcItemH = NULL;
+        suites.LayerSuite8()->AEGP_GetLayerSourceItem(layerH, &srcItemH);
+        if (srcItemH) {
+            A_long item_w = 0, item_h = 0;
+            suites.ItemSuite9()->AEGP_GetItemDimensions(srcItemH, &item_w, &item_h);
+            src_w = static_cast<int>(item_w);
+            src_h = static_cast<int>(item_h);
+        }
+    }
+    int downsample = force_full_res ? 1 : LetterboxDownsampleFactor(src_w, src_h, input_size);
+    DebugLog("Step 5b: source=" + std::to_string(src_w) + "x" + std::to_string(src_h) +
+             " downsample=" + std::to_string(downsample) +
+             (force_full_res ? " (full resolution forced)" : ""));
+
+    // --- 5c. Pick the model input shape ---
+    // A dynamic H/W model takes the smallest stride-aligned rectangle holding
+    // the frame (640x384 for 16:9) instead of a square that is mostly gray
+    // padding. Fixed-shape models, and unknown source sizes, stay square.
+    int input_w = input_size, input_h = input_size;
+    if (engine.HasDynamicInputSize())
+        LetterboxInputShape(src_w, src_h, input_size, kModelStride, input_w, input_h);
+    if (!engine.SetInputShape(input_w, input_h)) {
+        input_w = input_h = input_size;
+        engine.SetInputShape(input_w, input_h);
+    }
+    // FP16 and uint8 NHWC models take the letterbox output as half planes or
+    // RGB bytes on the zero-copy path; the copying paths stay float and the
+    // engine converts for them.
+    const bool half_input = engine.HasFloat16Input();
+    const bool rgb8_input = engine.HasRGB8Input();
+    DebugLog("Step 5c: model input " + std::to_string(input_w) + "x" + std::to_string(input_h) +
+             (half_input ? " (FP16)" : "") + (rgb8_input ? " (uint8 NHWC)" : ""));
+
     // conf_threshold is now passed in from the UI param
     DebugLog("Step 6: Using confidence threshold=" + std::to_string(conf_threshold));
 
     // --- 7. Process each frame (NO undo group here — rendering only) ---
     std::vector<KeypointResult> all_results(num_frames);
     std::vector<bool> frame_valid(num_frames, false);
+    std::vector<bool> frame_done(num_frames, false);   // detection ran (found or not)
+
+    // Resume a cancelled run of exactly this analysis. Anything that changes
+    // the detections (layer, timing, model, input shape, settings) gives a
+    // different key and starts over.
+    std::string checkpoint_key;
+    {
+        AEGP_ItemH compItemH = NULL;
+        A_long comp_id = 0;
+        if (!suites.CompSuite11()->AEGP_GetItemFromComp(compH, &compItemH) && compItemH)
+            suites.ItemSuite9()->AEGP_GetItemID(compItemH, &comp_id);
+        AEGP_LayerIDVal layer_id = 0;
+        suites.LayerSuite8()->AEGP_GetLayerID(layerH, &layer_id);
+        checkpoint_key = std::to_string(comp_id) + "/" + std::to_string(layer_id) +
+                         " in=" + std::to_string(in_point.value) + "/" + std::to_string(in_point.scale) +
+                         " frames=" + std::to_string(num_frames) + "@" + std::to_string(fps) +
+                         " model=" + engine.ActiveModelPath() +
+                         " input=" + std::to_string(input_w) + "x" + std::to_string(input_h) +
+                         " conf=" + std::to_string(conf_threshold) +
+                         " stride=" + std::to_string(std::max(1, skip_frames)) +
+                         " full=" + std::to_string(force_full_res) +
+                         " track=" + std::to_string(track_subject);
+    }
+    if (g_checkpoint.key == checkpoint_key) {
+        all_results = std::move(g_checkpoint.results);
+        frame_valid = std::move(g_checkpoint.valid);
+        frame_done  = std::move(g_checkpoint.done);
+        int resumed = 0;
+        for (bool d : frame_done) if (d) resumed++;
+        DebugLog("Step 7: Resuming cancelled analysis, " + std::to_string(resumed) +
+                 " frames already done");
+    }
+    g_checkpoint = AnalysisCheckpoint();
 
     DebugLog("Step 7: Rendering " + std::to_string(num_frames) + " frames...");
 
@@ -218,8 +326,32 @@ PF_Err AnalyzeAndWriteKeyframes(
 
     skip_frames = std::max(1, skip_frames);
 
+    // Render in the project's native bit depth: asking for 8-bit in a 16/32-bpc
+    // project makes AE run a conversion pass per frame and clips float
+    // highlights. LetterboxPreprocess reads all three depths directly.
+    AEGP_WorldType render_world_type = AEGP_WorldType_8;
+    {
+        AEGP_ProjectH projH = NULL;
+        AEGP_ProjBitDepth bit_depth = AEGP_ProjBitDepth_8;
+        if (!suites.ProjSuite6()->AEGP_GetProjectByIndex(0, &projH) && projH &&
+            !suites.ProjSuite6()->AEGP_GetProjectBitDepth(projH, &bit_depth)) {
+            if (bit_depth == AEGP_ProjBitDepth_16)      render_world_type = AEGP_WorldType_16;
+            else if (bit_depth == AEGP_ProjBitDepth_32) render_world_type = AEGP_WorldType_32;
+        }
+        DebugLog("Step 7: Render world type=" + std::to_string(static_cast<int>(render_world_type)) +
+                 " (project bit depth " + std::to_string(static_cast<int>(bit_depth)) + ")");
+    }
+
     // Pre-allocate buffers outside the frame loop to avoid per-frame heap churn.
+    // The letterbox plan (resample tables) is rebuilt only if the rendered
+    // frame geometry changes, which in practice means once per Analyze run.
+    LetterboxPlan lb_plan, crop_plan;
     std::vector<float> input_chw;
+
+    // Preprocessing row bands (0 = one per hardware thread).
+    int preprocess_threads = std::max(0, GetEnvInt("AE_YOLO_PREPROCESS_THREADS", 0));
+    DebugLog("Step 7: Preprocess threads=" +
+             (preprocess_threads ? std::to_string(preprocess_threads) : std::string("auto")));
     std::vector<float> raw_output;
     std::vector<int64_t> out_shape;
 
@@ -227,27 +359,158 @@ PF_Err AnalyzeAndWriteKeyframes(
              " (" + std::to_string((num_frames + skip_frames - 1) / skip_frames) +
              " YOLO calls for " + std::to_string(num_frames) + " frames)");
 
+    // Tracking crop: the previous detection box (full-res layer space) while
+    // tracking holds. The margin grows with the stride since the subject moves
+    // further between detections.
+    bool have_track = false;
+    DetectionBox track_box = {};
+    const float track_min_conf = std::max(conf_threshold, kTrackMinConf);
+    const float track_margin   = std::min(1.0f, 0.25f + 0.1f * skip_frames);
+    const bool  dynamic_input  = engine.HasDynamicInputSize();
+    int crop_count = 0, crop_fallbacks = 0;
+    if (track_subject) {
+        DebugLog("Step 7: Tracking crop on, margin=" + std::to_string(track_margin) +
+                 " min_conf=" + std::to_string(track_min_conf) +
+                 (dynamic_input ? " (dynamic input size)" : ""));
+    }
+
     int detect_count = 0;
     bool user_cancelled = false;
-    for (int f = 0; f < num_frames; f++) {
-        // Update progress
+
+    // The pass's last inference runs with arena shrinkage on. That is the
+    // last frame still to detect, which a resumed pass may already have
+    // done; a pass that never gets there releases the arena explicitly.
+    int last_todo = -1;
+    for (int f = num_frames - 1; f >= 0 && last_todo < 0; f--) {
+        bool in_stride = skip_frames <= 1 || f % skip_frames == 0 || f == num_frames - 1;
+        if (in_stride && !frame_done[f]) last_todo = f;
+    }
+    bool shrinking = false, arena_shrunk = false, ran_inference = false;
+
+    // Show progress done / total; true if the user pressed Cancel. AE's
+    // progress calls stay on this thread.
+    auto poll_progress = [&](int done, int total) -> bool {
         if (have_progress_dialog) {
             PF_Err prog_err = suites.AppSuite6()->PF_AppProgressDialogUpdate(
-                prog_dlg, static_cast<A_long>(f), static_cast<A_long>(num_frames));
+                prog_dlg, static_cast<A_long>(done), static_cast<A_long>(total));
             if (prog_err == PF_Interrupt_CANCEL) {
-                DebugLog("User cancelled via progress dialog at frame " + std::to_string(f));
-                user_cancelled = true;
-                break;
+                DebugLog("User cancelled via progress dialog at " + std::to_string(done) +
+                         "/" + std::to_string(total));
+                return true;
             }
         } else {
             // Fallback: PF_PROGRESS shows AE's built-in progress bar
-            PF_Err prog_err = PF_PROGRESS(in_data, f, num_frames);
+            PF_Err prog_err = PF_PROGRESS(in_data, done, total);
             if (prog_err == PF_Interrupt_CANCEL) {
-                DebugLog("User cancelled via PF_PROGRESS at frame " + std::to_string(f));
+                DebugLog("User cancelled via PF_PROGRESS at " + std::to_string(done) +
+                         "/" + std::to_string(total));
+                return true;
+            }
+        }
+        return false;
+    };
+    auto poll_cancel = [&](int f) { return poll_progress(f, num_frames); };
+
+    // Opt-in auto-tune (AE_YOLO_AUTOTUNE=1) queued by a load that found no
+    // profile for this model and machine: measure it here, before the
+    // frames, with its progress in the dialog, rather than unattended in the
+    // background. It runs on a worker so this thread keeps the dialog alive;
+    // Cancel stops it (it stays queued) and the analysis. The profile applies
+    // from the model's next load.
+    if (engine.TunePending()) {
+        DebugLog("Step 7: Running the queued auto-tune");
+        std::atomic<int> tune_step{0}, tune_steps{1};
+        std::atomic<bool> tune_cancel{false};
+        auto tune = std::async(std::launch::async, [&] {
+            return engine.RunPendingTune([&](int step, int steps) {
+                tune_step = step;
+                tune_steps = steps;
+                return !tune_cancel.load();
+            });
+        });
+        while (tune.wait_for(std::chrono::milliseconds(kCancelPollMs)) != std::future_status::ready) {
+            if (!tune_cancel && poll_progress(tune_step, tune_steps)) {
+                tune_cancel = true;
                 user_cancelled = true;
-                break;
             }
         }
+        tune.get();
+    }
+
+    // Run inference work for frame f on a worker thread while this thread
+    // keeps polling the progress dialog, so Cancel lands mid-inference (a
+    // slow CPU frame on the x model takes seconds) rather than at the next
+    // frame. Cancel terminates the run in the engine; returns false then.
+    engine.ResetCancel();
+    auto run_cancellable = [&](int f, auto work) -> bool {
+        std::future<bool> task = std::async(std::launch::async, work);
+        while (task.wait_for(std::chrono::milliseconds(kCancelPollMs)) != std::future_status::ready) {
+            if (!user_cancelled && poll_cancel(f)) {
+                user_cancelled = true;
+                engine.RequestCancel();
+            }
+        }
+        bool ok = task.get() && !user_cancelled;
+        ran_inference = true;
+        if (ok && shrinking) arena_shrunk = true;
+        return ok;
+    };
+
+    // Batched inference: letterboxed frames are queued and run N at a time.
+    // Tracking needs each frame's detection before cropping the next, so it
+    // always runs one frame at a time.
+    // The engine picks the size (tuned profile or session layout);
+    // AE_YOLO_BATCH_SIZE overrides it.
+    const int parallel_sessions = engine.ParallelSessionCount();
+    int default_batch = engine.PreferredBatchSize();
+    int batch_size = track_subject ? 1 : std::max(1, GetEnvInt("AE_YOLO_BATCH_SIZE", default_batch));
+    std::vector<std::vector<float>> batch_inputs(batch_size > 1 ? batch_size : 0);
+    std::vector<LetterboxInfo> batch_info(batch_size);
+    std::vector<int> batch_frame(batch_size);
+    std::vector<const float*> batch_ptrs(batch_size);
+    int batch_count = 0;
+    DebugLog("Step 7: Inference batch size=" + std::to_string(batch_size) +
+             (parallel_sessions > 1 ? " (" + std::to_string(parallel_sessions) + " parallel sessions)" :
+              engine.HasDynamicBatch() ? std::string(" (dynamic batch)") : std::string(" (fixed batch, looped)")));
+
+    auto record_detection = [&](int f) {
+        frame_valid[f] = true;
+        detect_count++;
+
+        // Log nose keypoint for first 5 detections to verify tracking
+        if (detect_count <= 5) {
+            DebugLog("DIAG f=" + std::to_string(f) +
+                     " nose=(" + std::to_string(all_results[f].x[0]) + "," +
+                     std::to_string(all_results[f].y[0]) + ")" +
+                     " lwrist=(" + std::to_string(all_results[f].x[9]) + "," +
+                     std::to_string(all_results[f].y[9]) + ")");
+        }
+    };
+
+    // Run the queued frames and postprocess each batch slice (f is the
+    // frame shown in the progress dialog meanwhile).
+    auto flush_batch = [&](int f) {
+        if (batch_count == 0) return;
+        for (int i = 0; i < batch_count; i++) batch_ptrs[i] = batch_inputs[i].data();
+        if (run_cancellable(f, [&] {
+                return engine.RunInferenceBatch(batch_ptrs.data(), batch_count, raw_output, out_shape);
+            })) {
+            for (int i = 0; i < batch_count; i++) {
+                int bf = batch_frame[i];
+                if (YoloPostprocessSlice(TensorView::Of(raw_output, out_shape), i, batch_info[i],
+                                         conf_threshold, all_results[bf]))
+                    record_detection(bf);
+                frame_done[bf] = true;
+            }
+        }
+        batch_count = 0;
+    };
+    for (int f = 0; f < num_frames && !user_cancelled; f++) {
+        // Update progress
+        if (poll_cancel(f)) {
+            user_cancelled = true;
+            break;
+        }
 
         // Log progress every 10 frames
         if (f % 10 == 0) {
@@ -260,6 +523,16 @@ PF_Err AnalyzeAndWriteKeyframes(
             continue;
         }
 
+        // Detected before a cancelled run stopped.
+        if (frame_done[f]) continue;
+
+        // Every inference from here on (this frame, or the batch it ends) is
+        // the pass's last, so let it release the arena's high-water mark.
+        if (f == last_todo) {
+            engine.SetArenaShrinkage(true);
+            shrinking = true;
+        }
+
         // Compute comp time for this frame (also used for keyframe writing)
         A_Time comp_time;
         comp_time.scale = time_scale;
@@ -270,14 +543,34 @@ PF_Err AnalyzeAndWriteKeyframes(
         A_Time render_time = {};
         suites.LayerSuite8()->AEGP_ConvertCompToLayerTime(layerH, &comp_time, &render_time);
 
+        // Tracking: crop around the last confident box. The render factor then
+        // follows the crop so it still covers the model input.
+        LetterboxCropRect crop_full = {};
+        bool use_crop = false;
+        int crop_input = input_size;
+        int frame_downsample = downsample;
+        if (track_subject && have_track) {
+            use_crop = LetterboxCropAround(track_box.x1, track_box.y1, track_box.x2, track_box.y2,
+                                           track_margin, src_w, src_h, kTrackCropQuantum, crop_full);
+            if (use_crop) {
+                if (dynamic_input) {
+                    int side = (std::max(crop_full.w, crop_full.h) + kModelStride - 1) / kModelStride * kModelStride;
+                    crop_input = std::min(input_size, std::max(kMinCropInput, side));
+                }
+                frame_downsample = force_full_res ? 1 :
+                    LetterboxDownsampleFactor(crop_full.w, crop_full.h, crop_input);
+            }
+        }
+
         // Create fresh render options per frame to ensure AEGP_SetTime is respected.
         AEGP_LayerRenderOptionsH frameOptsH = NULL;
         err = suites.LayerRenderOptionsSuite1()->AEGP_NewFromUpstreamOfEffect(
             g_aegp_plugin_id, effectRefH, &frameOptsH);
         if (err || !frameOptsH) continue;
 
-        suites.LayerRenderOptionsSuite1()->AEGP_SetWorldType(frameOptsH, AEGP_WorldType_8);
-        suites.LayerRenderOptionsSuite1()->AEGP_SetDownsampleFactor(frameOptsH, 1, 1);
+        suites.LayerRenderOptionsSuite1()->AEGP_SetWorldType(frameOptsH, render_world_type);
+        suites.LayerRenderOptionsSuite1()->AEGP_SetDownsampleFactor(
+            frameOptsH, static_cast<A_short>(frame_downsample), static_cast<A_short>(frame_downsample));
         err = suites.LayerRenderOptionsSuite1()->AEGP_SetTime(frameOptsH, render_time);
         if (err) {
             suites.LayerRenderOptionsSuite1()->AEGP_Dispose(frameOptsH);
@@ -304,8 +597,28 @@ PF_Err AnalyzeAndWriteKeyframes(
         suites.WorldSuite3()->AEGP_GetSize(worldH, &width, &height);
         suites.WorldSuite3()->AEGP_GetRowBytes(worldH, &row_bytes);
 
-        PF_Pixel8* base_addr = NULL;
-        suites.WorldSuite3()->AEGP_GetBaseAddr8(worldH, &base_addr);
+        // AE may still hand back a different depth than requested; trust the world.
+        AEGP_WorldType world_type = AEGP_WorldType_8;
+        suites.WorldSuite3()->AEGP_GetType(worldH, &world_type);
+
+        const unsigned char* base_addr = NULL;
+        int bytes_per_channel = 1;
+        if (world_type == AEGP_WorldType_32) {
+            PF_PixelFloat* addr = NULL;
+            suites.WorldSuite3()->AEGP_GetBaseAddr32(worldH, &addr);
+            base_addr = reinterpret_cast<const unsigned char*>(addr);
+            bytes_per_channel = sizeof(PF_FpShort);
+        } else if (world_type == AEGP_WorldType_16) {
+            PF_Pixel16* addr = NULL;
+            suites.WorldSuite3()->AEGP_GetBaseAddr16(worldH, &addr);
+            base_addr = reinterpret_cast<const unsigned char*>(addr);
+            bytes_per_channel = sizeof(A_u_short);
+        } else {
+            PF_Pixel8* addr = NULL;
+            suites.WorldSuite3()->AEGP_GetBaseAddr8(worldH, &addr);
+            base_addr = reinterpret_cast<const unsigned char*>(addr);
+        }
+        const int bytes_per_pixel = bytes_per_channel * 4;
 
         if (base_addr && width > 0 && height > 0) {
             // Diagnostic: comprehensive frame analysis for first 5 processed frames
@@ -317,26 +630,32 @@ PF_Err AnalyzeAndWriteKeyframes(
                 // Hash the entire frame (FNV-1a on every 100th pixel for speed)
                 uint32_t frame_hash = 2166136261u;
                 for (int row = 0; row < height; row += 10) {
-                    const unsigned char* row_ptr =
-                        reinterpret_cast<const unsigned char*>(base_addr) + row * row_bytes;
+                    const unsigned char* row_ptr = base_addr + static_cast<size_t>(row) * row_bytes;
                     for (int col = 0; col < width; col += 10) {
-                        const unsigned char* p = row_ptr + col * 4;
-                        frame_hash ^= p[1]; frame_hash *= 16777619u; // R
-                        frame_hash ^= p[2]; frame_hash *= 16777619u; // G
-                        frame_hash ^= p[3]; frame_hash *= 16777619u; // B
+                        const unsigned char* p = row_ptr + col * bytes_per_pixel;
+                        for (int b = bytes_per_channel; b < bytes_per_pixel; b++) {   // R, G, B
+                            frame_hash ^= p[b]; frame_hash *= 16777619u;
+                        }
                     }
                 }
 
                 // Sample 5 pixels across the diagonal
+                auto channel_str = [&](const unsigned char* px, int c) {
+                    if (world_type == AEGP_WorldType_32)
+                        return std::to_string(reinterpret_cast<const PF_FpShort*>(px)[c]);
+                    if (world_type == AEGP_WorldType_16)
+                        return std::to_string(reinterpret_cast<const A_u_short*>(px)[c]);
+                    return std::to_string(px[c]);
+                };
                 std::string diag_pixels;
                 for (int i = 0; i < 5; i++) {
                     int sx = width * (i + 1) / 6;
                     int sy = height * (i + 1) / 6;
-                    const PF_Pixel8* px = reinterpret_cast<const PF_Pixel8*>(
-                        reinterpret_cast<const char*>(base_addr) + sy * row_bytes) + sx;
-                    diag_pixels += "(" + std::to_string(px->red) + "," +
-                                   std::to_string(px->green) + "," +
-                                   std::to_string(px->blue) + ") ";
+                    const unsigned char* px =
+                        base_addr + static_cast<size_t>(sy) * row_bytes + sx * bytes_per_pixel;
+                    diag_pixels += "(" + channel_str(px, 1) + "," +
+                                   channel_str(px, 2) + "," +
+                                   channel_str(px, 3) + ") ";
                 }
 
                 DebugLog("DIAG f=" + std::to_string(f) +
@@ -350,35 +669,115 @@ PF_Err AnalyzeAndWriteKeyframes(
                 DebugLog("DIAG f=" + std::to_string(f) + " diag_px: " + diag_pixels);
             }
 
-            LetterboxInfo lb_info = LetterboxPreprocess(
-                reinterpret_cast<const unsigned char*>(base_addr),
-                static_cast<int>(width), static_cast<int>(height),
-                static_cast<int>(row_bytes),
-                input_size,
-                input_chw);
-
-            if (YoloEngine::RunInference(input_chw.data(), raw_output, out_shape)) {
-                if (YoloPostprocess(raw_output, out_shape, lb_info,
-                                     conf_threshold, all_results[f])) {
-                    frame_valid[f] = true;
-                    detect_count++;
-
-                    // Log nose keypoint for first 5 detections to verify tracking
-                    if (detect_count <= 5) {
-                        DebugLog("DIAG f=" + std::to_string(f) +
-                                 " nose=(" + std::to_string(all_results[f].x[0]) + "," +
-                                 std::to_string(all_results[f].y[0]) + ")" +
-                                 " lwrist=(" + std::to_string(all_results[f].x[9]) + "," +
-                                 std::to_string(all_results[f].y[9]) + ")");
+            // Letterbox `region` of the rendered frame at model_w x model_h into
+            // dst (float or Float16 planes, or uint8 HWC) and return info that
+            // remaps to full-res layer space. The full-frame and crop geometries keep
+            // separate plans so alternating between them does not rebuild
+            // tables every frame.
+            auto letterbox = [&](const LetterboxCropRect& region, LetterboxPlan& plan,
+                                 int model_w, int model_h, auto& dst) -> LetterboxInfo {
+                if (!plan.Matches(region.w, region.h, static_cast<int>(row_bytes), model_w, model_h)) {
+                    plan = BuildLetterboxPlan(region.w, region.h, static_cast<int>(row_bytes),
+                                              model_w, model_h);
+                    DebugLog("Letterbox plan built for " + std::to_string(region.w) + "x" +
+                             std::to_string(region.h) + " -> " + std::to_string(model_w) + "x" +
+                             std::to_string(model_h));
+                }
+
+                const unsigned char* origin =
+                    base_addr + static_cast<size_t>(region.y) * row_bytes + region.x * bytes_per_pixel;
+                auto run = [&](auto pixels) {
+                    if constexpr (std::is_same<std::decay_t<decltype(dst)>, std::vector<unsigned char>>::value)
+                        return LetterboxPreprocessRGB8(plan, pixels, dst, LetterboxKernel::Auto, preprocess_threads);
+                    else
+                        return LetterboxPreprocess(plan, pixels, dst, LetterboxKernel::Auto, preprocess_threads);
+                };
+                LetterboxInfo lb_info;
+                if (world_type == AEGP_WorldType_32) {
+                    lb_info = run(reinterpret_cast<const PF_FpShort*>(origin));
+                } else if (world_type == AEGP_WorldType_16) {
+                    lb_info = run(reinterpret_cast<const A_u_short*>(origin));
+                } else {
+                    lb_info = run(origin);
+                }
+                lb_info = LetterboxToCrop(lb_info, region, static_cast<int>(width), static_cast<int>(height));
+                return LetterboxToFullRes(lb_info, frame_downsample, src_w, src_h);
+            };
+
+            // Single-frame letterbox + inference + postprocess. At the session's
+            // current input shape the frame is letterboxed straight into the
+            // engine's bound input and the output is read in place; square crop
+            // inputs on dynamic models go through the copying path.
+            auto detect = [&](const LetterboxCropRect& region, LetterboxPlan& plan,
+                              int model_w, int model_h,
+                              KeypointResult& result, DetectionBox& box) -> bool {
+                if (model_w == input_w && model_h == input_h) {
+                    LetterboxInfo lb_info =
+                        rgb8_input ? letterbox(region, plan, model_w, model_h, engine.InputBufferRGB8()) :
+                        half_input ? letterbox(region, plan, model_w, model_h, engine.InputBufferHalf()) :
+                                     letterbox(region, plan, model_w, model_h, engine.InputBuffer());
+                    TensorView output;
+                    return engine.RunInference(output) &&
+                           YoloPostprocess(output, lb_info, conf_threshold, result, &box);
+                }
+                LetterboxInfo lb_info = letterbox(region, plan, model_w, model_h, input_chw);
+                return engine.RunInference(input_chw.data(), model_w, raw_output, out_shape) &&
+                       YoloPostprocess(TensorView::Of(raw_output, out_shape), lb_info,
+                                       conf_threshold, result, &box);
+            };
+
+            LetterboxCropRect whole = { 0, 0, static_cast<int>(width), static_cast<int>(height) };
+            if (batch_size > 1) {
+                // Queue the frame; results are written when the batch runs.
+                batch_info[batch_count] = letterbox(whole, lb_plan, input_w, input_h,
+                                                    batch_inputs[batch_count]);
+                batch_frame[batch_count] = f;
+                if (++batch_count == batch_size) flush_batch(f);
+            } else {
+                DetectionBox box = {};
+                bool found = false;
+                bool completed = run_cancellable(f, [&] {
+                    if (use_crop) {
+                        // Crop rectangle in rendered pixels; size is fixed by the full-res
+                        // crop so the plan is reused while the subject moves.
+                        LetterboxCropRect region;
+                        region.w = std::min(static_cast<int>(width),
+                                            (crop_full.w + frame_downsample - 1) / frame_downsample);
+                        region.h = std::min(static_cast<int>(height),
+                                            (crop_full.h + frame_downsample - 1) / frame_downsample);
+                        region.x = std::min(crop_full.x / frame_downsample, static_cast<int>(width) - region.w);
+                        region.y = std::min(crop_full.y / frame_downsample, static_cast<int>(height) - region.h);
+
+                        crop_count++;
+                        found = detect(region, crop_plan, crop_input, crop_input, all_results[f], box) &&
+                                box.confidence >= track_min_conf;
+                        if (!found) crop_fallbacks++;
                     }
+                    if (!found)
+                        found = detect(whole, lb_plan, input_w, input_h, all_results[f], box);
+                    return true;   // a miss is still a finished frame; only Cancel is not
+                });
+                if (completed) {
+                    have_track = found && box.confidence >= track_min_conf;
+                    if (have_track) track_box = box;
+
+                    if (found) record_detection(f);
+                    frame_done[f] = true;
                 }
             }
         }
 
         suites.RenderSuite5()->AEGP_CheckinFrame(receiptH);
         suites.LayerRenderOptionsSuite1()->AEGP_Dispose(frameOptsH);
+        if (user_cancelled) break;
     }
 
+    // Run any frames still queued (a cancelled run discards them anyway).
+    if (!user_cancelled) flush_batch(num_frames - 1);
+    // Cancelled, or the last frame failed to render: no run shrank the arena.
+    if (ran_inference && !arena_shrunk) engine.ReleaseArenaMemory();
+    engine.SetArenaShrinkage(false);
+
     // Dispose progress dialog
     if (have_progress_dialog && prog_dlg) {
         suites.AppSuite6()->PF_DisposeAppProgressDialog(prog_dlg);
@@ -387,9 +786,17 @@ PF_Err AnalyzeAndWriteKeyframes(
     }
 
     DebugLog("Step 7: Frame loop complete");
+    if (track_subject) {
+        DebugLog("Step 7: Tracking crops=" + std::to_string(crop_count) +
+                 " full-frame fallbacks=" + std::to_string(crop_fallbacks));
+    }
 
-    // If user cancelled, clean up and bail
+    // If user cancelled, keep what was detected for a resume, clean up and bail
     if (user_cancelled) {
+        g_checkpoint.key     = checkpoint_key;
+        g_checkpoint.results = std::move(all_results);
+        g_checkpoint.valid   = std::move(frame_valid);
+        g_checkpoint.done    = std::move(frame_done);
         DebugLog("Analysis cancelled by user, skipping keyframe writing");
         suites.EffectSuite4()->AEGP_DisposeEffect(effectRefH);
         return PF_Err_NONE;
@@ -8,6 +8,10 @@
 // conf_threshold: minimum detection confidence (0-1)
 // smooth_window: SavGol window size (odd, 1=disabled)
 // smooth_order: SavGol polynomial order (1-5)
+// force_full_res: render at full resolution instead of the largest AE
+//   downsample factor that still covers the model input size
+// track_subject: letterbox a crop around the previous frame's detection and
+//   fall back to the full frame when confidence drops
 // Returns PF_Err_NONE on success.
 PF_Err AnalyzeAndWriteKeyframes(
     PF_InData* in_data,
@@ -15,4 +19,6 @@ PF_Err AnalyzeAndWriteKeyframes(
     float conf_threshold = 0.25f,
     int smooth_window = 7,
     int smooth_order = 3,
-    int skip_frames = 1);
+    int skip_frames = 1,
+    bool force_full_res = false,
+    bool track_subject = false);
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "TensorView.h"
+
+// What the analysis pipeline needs from an inference engine: making a model's
+// session active, its input shape, and single / batched runs. FrameAnalyzer
+// and the plugin talk to YoloEngine::Backend() through this, so the engine
+// can be swapped without touching them: the ONNX Runtime engine
+// (YoloEngine.cpp) in production, or StubBackend, which needs no model file
+// and no ONNX Runtime, for load tests of letterboxing, batching, cancel and
+// smoothing.
+//
+// The calls mean exactly what the YoloEngine functions of the same name do;
+// see YoloEngine.h for the details.
+class InferenceBackend {
+public:
+    virtual ~InferenceBackend() = default;
+
+    // Short name for logs ("onnxruntime", "stub").
+    virtual const char* Name() const = 0;
+
+    // --- Sessions ---
+    virtual void EnsureSession(const char* model_path_utf8, bool use_gpu, int input_size = 0) = 0;
+    virtual void PreloadSession(const char* /*model_path_utf8*/, bool /*use_gpu*/, int /*input_size*/ = 0) {}
+    virtual bool IsReady() = 0;
+    virtual std::string ActiveModelPath() = 0;
+
+    // --- Input shape ---
+    virtual int  GetInputSize() = 0;
+    virtual bool HasDynamicInputSize() = 0;
+    virtual bool SetInputShape(int width, int height) = 0;
+    virtual int  GetInputWidth() = 0;
+    virtual int  GetInputHeight() = 0;
+    virtual bool HasDynamicBatch() = 0;
+    virtual int  ParallelSessionCount() = 0;
+    virtual int  PreferredBatchSize() = 0;
+
+    // Input element types other than float. Backends without FP16 or uint8
+    // models keep the defaults, and their half / byte buffers stay empty.
+    virtual bool HasFloat16Input() { return false; }
+    virtual bool HasRGB8Input() { return false; }
+    virtual std::vector<Float16>& InputBufferHalf() {
+        static std::vector<Float16> empty;
+        return empty;
+    }
+    virtual std::vector<unsigned char>& InputBufferRGB8() {
+        static std::vector<unsigned char> empty;
+        return empty;
+    }
+
+    // --- Runs ---
+    // Zero-copy single image: fill InputBuffer(), then RunInference(output).
+    virtual std::vector<float>& InputBuffer() = 0;
+    virtual bool RunInference(TensorView& output) = 0;
+
+    // Copying single image (input_size 0 = the current shape) and batch.
+    virtual bool RunInference(const float* input_chw, int input_size,
+                              std::vector<float>& raw_output,
+                              std::vector<int64_t>& out_shape) = 0;
+    virtual bool RunInferenceBatch(const float* const* inputs, int n,
+                                   std::vector<float>& raw_output,
+                                   std::vector<int64_t>& out_shape) = 0;
+
+    // Abort runs in flight (they report failure) until ResetCancel().
+    virtual void RequestCancel() = 0;
+    virtual void ResetCancel() = 0;
+
+    // --- Resources ---
+    // Pin() keeps the loaded model from being unloaded as idle until the
+    // matching Unpin(); hold a BackendPin across an analysis pass. Arena
+    // shrinkage and release hand a pass's peak memory back to the OS. All
+    // are no-ops for backends without idle unloading or an arena.
+    virtual void Pin() {}
+    virtual void Unpin() {}
+    virtual void SetArenaShrinkage(bool /*enable*/) {}
+    virtual void ReleaseArenaMemory() {}
+
+    // --- Tuning ---
+    // A measurement of this machine queued by a load, run on request with
+    // progress (see YoloEngine::RunPendingTune). Backends without tuning
+    // never have one pending.
+    virtual bool TunePending() { return false; }
+    virtual bool RunPendingTune(const std::function<bool(int, int)>& /*progress*/) { return false; }
+};
+
+// Holds a Pin() on a backend for its lifetime.
+class BackendPin {
+public:
+    explicit BackendPin(InferenceBackend& backend) : backend_(backend) { backend_.Pin(); }
+    ~BackendPin() { backend_.Unpin(); }
+    BackendPin(const BackendPin&) = delete;
+    BackendPin& operator=(const BackendPin&) = delete;
+
+private:
+    InferenceBackend& backend_;
+};
@@ -0,0 +1,1062 @@
+#include "Letterbox.h"
+#include "ThreadPool.h"
+
+#include <cstdint>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+    #define LETTERBOX_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        // MSVC emits any intrinsic regardless of /arch; dispatch is at runtime.
+        #define LETTERBOX_TARGET_SSE41
+        #define LETTERBOX_TARGET_AVX2
+    #else
+        #define LETTERBOX_TARGET_SSE41 __attribute__((target("sse4.1")))
+        #define LETTERBOX_TARGET_AVX2  __attribute__((target("avx2")))
+    #endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define LETTERBOX_NEON 1
+    #include <arm_neon.h>
+#endif
+
+// ============================================================================
+// CPU feature detection
+// ============================================================================
+#if defined(LETTERBOX_X86)
+static bool CpuHasSSE41() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 19)) != 0;
+#else
+    return __builtin_cpu_supports("sse4.1");
+#endif
+}
+
+static bool CpuHasAVX2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx     = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx) return false;
+    if ((_xgetbv(0) & 0x6) != 0x6) return false;   // OS saves YMM state
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+bool LetterboxKernelSupported(LetterboxKernel kernel) {
+    switch (kernel) {
+        case LetterboxKernel::Auto:
+        case LetterboxKernel::Scalar:
+            return true;
+#if defined(LETTERBOX_X86)
+        case LetterboxKernel::SSE41: {
+            static const bool ok = CpuHasSSE41();
+            return ok;
+        }
+        case LetterboxKernel::AVX2: {
+            static const bool ok = CpuHasAVX2();
+            return ok;
+        }
+#endif
+#if defined(LETTERBOX_NEON)
+        case LetterboxKernel::NEON:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+static LetterboxKernel ResolveKernel(LetterboxKernel requested) {
+    if (requested != LetterboxKernel::Auto && LetterboxKernelSupported(requested))
+        return requested;
+    if (LetterboxKernelSupported(LetterboxKernel::AVX2))  return LetterboxKernel::AVX2;
+    if (LetterboxKernelSupported(LetterboxKernel::SSE41)) return LetterboxKernel::SSE41;
+    if (LetterboxKernelSupported(LetterboxKernel::NEON))  return LetterboxKernel::NEON;
+    return LetterboxKernel::Scalar;
+}
+
+// ============================================================================
+// Fixed-point resample math
+//
+// Weights are Q14 (0..16384). The horizontal lerp of two 8-bit samples gives a
+// Q14 value (< 2^22) that is rounded down to Q8 so the vertical lerp with a
+// second Q14 weight still fits in int32 (< 2^30). The only float op is the
+// final int→float scale to [0,1]. Every kernel runs exactly this integer
+// sequence, so SIMD output is bit-identical to the scalar reference.
+// ============================================================================
+static const int     kWeightBits  = 14;
+static const int32_t kWeightOne   = 1 << kWeightBits;
+static const int     kHorizShift  = 6;                       // Q14 → Q8
+static const int32_t kHorizRound  = 1 << (kHorizShift - 1);
+static const float   kOutputScale = 1.0f / (255.0f * (1 << (2 * kWeightBits - kHorizShift)));
+
+// a * (1 - w) + b * w  ==  (a << 14) + (b - a) * w
+static inline int32_t LerpQ14(int32_t a, int32_t b, int32_t w) {
+    return (a << kWeightBits) + (b - a) * w;
+}
+
+// ============================================================================
+// Channel depths
+//
+// 8-bpc runs the Q14 integer pipeline above. 16- and 32-bpc sources are lerped
+// in float on their native scale with the same plan weights, then scaled to
+// [0,1] and clamped. Scalar and SIMD float kernels run the same mul/add
+// sequence (no FMA), so on x86 they also match bit for bit.
+// ============================================================================
+template <typename Channel> struct ChannelTraits;
+
+template <> struct ChannelTraits<unsigned char> {
+    typedef int32_t Sum;                        // area box sums
+    static float Range() { return 255.0f; }
+    static float Store(float v) { return v; }   // integer path is already in [0,1]
+};
+
+template <> struct ChannelTraits<uint16_t> {
+    typedef int32_t Sum;                        // 36 × 32768 < 2^31
+    static float Range() { return 32768.0f; }
+    static float Store(float v) { return v > 0.0f ? (v < 1.0f ? v : 1.0f) : 0.0f; }
+};
+
+template <> struct ChannelTraits<float> {
+    typedef float Sum;
+    static float Range() { return 1.0f; }
+    // Clamp to [0,1]; NaN → 0 (same as SIMD min(max(v, 0), 1)) unless fast-math
+    // folds the comparisons.
+    static float Store(float v) { return v > 0.0f ? (v < 1.0f ? v : 1.0f) : 0.0f; }
+};
+
+static const float kWeightScale = 1.0f / kWeightOne;
+
+// ============================================================================
+// Plan
+// ============================================================================
+LetterboxPlan BuildLetterboxPlan(int width, int height, int rowbytes,
+                                 int target_w, int target_h, LetterboxFilter filter) {
+    LetterboxPlan plan;
+    plan.src_w = width;
+    plan.src_h = height;
+    plan.rowbytes = rowbytes;
+    plan.target_w = target_w;
+    plan.target_h = target_h;
+
+    LetterboxInfo& info = plan.info;
+    info.orig_w = width;
+    info.orig_h = height;
+    info.input_w = target_w;
+    info.input_h = target_h;
+
+    // Calculate scale and padding
+    info.scale = std::min(
+        static_cast<float>(target_w) / width,
+        static_cast<float>(target_h) / height);
+    plan.new_w = std::min(static_cast<int>(std::round(width * info.scale)), target_w);
+    plan.new_h = std::min(static_cast<int>(std::round(height * info.scale)), target_h);
+
+    // Use integer division so placement (pad_left/pad_top) and remapping
+    // (info.pad_x/pad_y) always agree — avoids sub-pixel systematic error.
+    plan.pad_left = (target_w - plan.new_w) / 2;
+    plan.pad_top  = (target_h - plan.new_h) / 2;
+    info.pad_x = static_cast<float>(plan.pad_left);
+    info.pad_y = static_cast<float>(plan.pad_top);
+
+    // Source position of output pixel i is i / scale; split into an index and a
+    // Q14 fraction. The last source pixel/row is clamped (weight 0 on the edge).
+    auto build_axis = [&](int count, int max_src,
+                          std::vector<int32_t>& idx0, std::vector<int32_t>& idx1,
+                          std::vector<int32_t>& weight) {
+        idx0.resize(count);
+        idx1.resize(count);
+        weight.resize(count);
+        const double inv_scale = 1.0 / info.scale;
+        for (int i = 0; i < count; i++) {
+            double src = i * inv_scale;
+            int s0 = static_cast<int>(src);
+            int32_t w = static_cast<int32_t>(std::lround((src - s0) * kWeightOne));
+            if (w >= kWeightOne) { s0++; w = 0; }
+            if (s0 >= max_src) { s0 = max_src; w = 0; }
+            idx0[i] = s0;
+            idx1[i] = std::min(s0 + 1, max_src);
+            weight[i] = w;
+        }
+    };
+
+    // Output pixel i covers source span [i / scale, (i + 1) / scale). Each
+    // overlapped source pixel gets its coverage fraction as a Q14 weight; the
+    // rounding remainder goes to the largest tap so the taps sum to exactly 1.
+    auto build_area_axis = [&](int count, int src_len, std::vector<int32_t>& start,
+                               std::vector<int32_t>& index, std::vector<int32_t>& weight) {
+        start.assign(count + 1, 0);
+        index.clear();
+        weight.clear();
+        const double inv_scale = 1.0 / info.scale;
+        for (int i = 0; i < count; i++) {
+            double s0 = std::min(i * inv_scale, static_cast<double>(src_len - 1));
+            double s1 = std::min((i + 1) * inv_scale, static_cast<double>(src_len));
+            if (s1 <= s0) s1 = s0 + 1.0;
+            start[i] = static_cast<int32_t>(index.size());
+            int first = static_cast<int>(s0);
+            int last  = std::min(static_cast<int>(std::ceil(s1)) - 1, src_len - 1);
+            int32_t sum = 0;
+            size_t largest = index.size();
+            for (int p = first; p <= last; p++) {
+                double cover = std::min(p + 1.0, s1) - std::max(static_cast<double>(p), s0);
+                if (cover <= 0.0) continue;
+                int32_t w = static_cast<int32_t>(std::lround(cover / (s1 - s0) * kWeightOne));
+                if (index.size() == static_cast<size_t>(start[i]) || w > weight[largest])
+                    largest = index.size();
+                index.push_back(p);
+                weight.push_back(w);
+                sum += w;
+            }
+            weight[largest] += kWeightOne - sum;
+        }
+        start[count] = static_cast<int32_t>(index.size());
+    };
+
+    if (filter == LetterboxFilter::Auto)
+        filter = info.scale < 0.5f ? LetterboxFilter::Area : LetterboxFilter::Bilinear;
+    plan.filter = filter;
+
+    if (filter == LetterboxFilter::Area) {
+        build_area_axis(plan.new_w, width, plan.col_tap_start, plan.col_tap_index, plan.col_tap_weight);
+        build_area_axis(plan.new_h, height, plan.row_tap_start, plan.row_tap_index, plan.row_tap_weight);
+
+        // Exact k×k box when the frame divides evenly (e.g. UHD 3840×2160 → 6×).
+        for (int k : { 2, 3, 4, 6 }) {
+            if (std::fabs(info.scale * k - 1.0f) < 1e-6f &&
+                width % k == 0 && height % k == 0 &&
+                plan.new_w == width / k && plan.new_h == height / k) {
+                plan.area_ratio = k;
+                break;
+            }
+        }
+        return plan;
+    }
+
+    build_axis(plan.new_w, width - 1, plan.col_x0, plan.col_x1, plan.col_wx);
+
+    std::vector<int32_t> row0, row1;
+    build_axis(plan.new_h, height - 1, row0, row1, plan.row_wy);
+    plan.row_off0.resize(plan.new_h);
+    plan.row_off1.resize(plan.new_h);
+    for (int y = 0; y < plan.new_h; y++) {
+        plan.row_off0[y] = static_cast<size_t>(row0[y]) * rowbytes;
+        plan.row_off1[y] = static_cast<size_t>(row1[y]) * rowbytes;
+    }
+
+    return plan;
+}
+
+// ============================================================================
+// Row kernels
+//
+// Each kernel resamples output columns [x_begin, x_end) of one letterboxed row
+// from source rows row0/row1 and writes R, G, B directly into their CHW planes.
+// ============================================================================
+struct RowArgs {
+    const unsigned char* row0;  // source row sy0 (bytes; cast per channel type)
+    const unsigned char* row1;  // source row sy1
+    int32_t wy;                 // Q14 weight of row1
+    const int32_t* x0;          // plan.col_x0
+    const int32_t* x1;          // plan.col_x1
+    const int32_t* wx;          // plan.col_wx
+    float* dst_r;               // output row start in each plane (after pad_left)
+    float* dst_g;
+    float* dst_b;
+};
+
+static void ResampleRowScalar(const RowArgs& a, int x_begin, int x_end) {
+    for (int x = x_begin; x < x_end; x++) {
+        // AE pixel layout: ARGB (alpha at offset 0, red at 1, green at 2, blue at 3)
+        const unsigned char* p00 = a.row0 + a.x0[x] * 4;
+        const unsigned char* p01 = a.row0 + a.x1[x] * 4;
+        const unsigned char* p10 = a.row1 + a.x0[x] * 4;
+        const unsigned char* p11 = a.row1 + a.x1[x] * 4;
+        int32_t wx = a.wx[x];
+
+        float* dst[3] = { a.dst_r, a.dst_g, a.dst_b };
+        for (int c = 0; c < 3; c++) {
+            int ae_offset = c + 1; // skip alpha: R=1, G=2, B=3
+            int32_t top = (LerpQ14(p00[ae_offset], p01[ae_offset], wx) + kHorizRound) >> kHorizShift;
+            int32_t bot = (LerpQ14(p10[ae_offset], p11[ae_offset], wx) + kHorizRound) >> kHorizShift;
+            dst[c][x] = static_cast<float>(LerpQ14(top, bot, a.wy)) * kOutputScale;
+        }
+    }
+}
+
+#if defined(LETTERBOX_X86)
+// Integer lerp: (a << 14) + (b - a) * w, 8 lanes.
+LETTERBOX_TARGET_AVX2
+static inline __m256i Avx2LerpQ14(__m256i a, __m256i b, __m256i w) {
+    return _mm256_add_epi32(_mm256_slli_epi32(a, kWeightBits),
+                            _mm256_mullo_epi32(_mm256_sub_epi32(b, a), w));
+}
+
+// One channel of 8 gathered ARGB pixels (as little-endian uint32) through the
+// full 2D lerp, scaled to [0,1].
+LETTERBOX_TARGET_AVX2
+static inline __m256 Avx2Channel(__m256i p00, __m256i p01, __m256i p10, __m256i p11,
+                                 __m128i shift, __m256i wx, __m256i wy) {
+    const __m256i mask  = _mm256_set1_epi32(0xFF);
+    const __m256i round = _mm256_set1_epi32(kHorizRound);
+    __m256i c00 = _mm256_and_si256(_mm256_srl_epi32(p00, shift), mask);
+    __m256i c01 = _mm256_and_si256(_mm256_srl_epi32(p01, shift), mask);
+    __m256i c10 = _mm256_and_si256(_mm256_srl_epi32(p10, shift), mask);
+    __m256i c11 = _mm256_and_si256(_mm256_srl_epi32(p11, shift), mask);
+    __m256i top = _mm256_srai_epi32(_mm256_add_epi32(Avx2LerpQ14(c00, c01, wx), round), kHorizShift);
+    __m256i bot = _mm256_srai_epi32(_mm256_add_epi32(Avx2LerpQ14(c10, c11, wx), round), kHorizShift);
+    return _mm256_mul_ps(_mm256_cvtepi32_ps(Avx2LerpQ14(top, bot, wy)),
+                         _mm256_set1_ps(kOutputScale));
+}
+
+LETTERBOX_TARGET_AVX2
+static void ResampleRowAVX2(const RowArgs& a, int x_begin, int x_end) {
+    const int* r0 = reinterpret_cast<const int*>(a.row0);
+    const int* r1 = reinterpret_cast<const int*>(a.row1);
+    const __m256i vwy = _mm256_set1_epi32(a.wy);
+    const __m128i shift_r = _mm_cvtsi32_si128(8);
+    const __m128i shift_g = _mm_cvtsi32_si128(16);
+    const __m128i shift_b = _mm_cvtsi32_si128(24);
+
+    int x = x_begin;
+    for (; x + 8 <= x_end; x += 8) {
+        __m256i sx0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a.x0 + x));
+        __m256i sx1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a.x1 + x));
+        __m256i wx  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a.wx + x));
+
+        __m256i p00 = _mm256_i32gather_epi32(r0, sx0, 4);
+        __m256i p01 = _mm256_i32gather_epi32(r0, sx1, 4);
+        __m256i p10 = _mm256_i32gather_epi32(r1, sx0, 4);
+        __m256i p11 = _mm256_i32gather_epi32(r1, sx1, 4);
+
+        _mm256_storeu_ps(a.dst_r + x, Avx2Channel(p00, p01, p10, p11, shift_r, wx, vwy));
+        _mm256_storeu_ps(a.dst_g + x, Avx2Channel(p00, p01, p10, p11, shift_g, wx, vwy));
+        _mm256_storeu_ps(a.dst_b + x, Avx2Channel(p00, p01, p10, p11, shift_b, wx, vwy));
+    }
+    ResampleRowScalar(a, x, x_end);
+}
+
+LETTERBOX_TARGET_SSE41
+static inline __m128i Sse41LerpQ14(__m128i a, __m128i b, __m128i w) {
+    return _mm_add_epi32(_mm_slli_epi32(a, kWeightBits),
+                         _mm_mullo_epi32(_mm_sub_epi32(b, a), w));
+}
+
+LETTERBOX_TARGET_SSE41
+static inline __m128 Sse41Channel(__m128i p00, __m128i p01, __m128i p10, __m128i p11,
+                                  __m128i shift, __m128i wx, __m128i wy) {
+    const __m128i mask  = _mm_set1_epi32(0xFF);
+    const __m128i round = _mm_set1_epi32(kHorizRound);
+    __m128i c00 = _mm_and_si128(_mm_srl_epi32(p00, shift), mask);
+    __m128i c01 = _mm_and_si128(_mm_srl_epi32(p01, shift), mask);
+    __m128i c10 = _mm_and_si128(_mm_srl_epi32(p10, shift), mask);
+    __m128i c11 = _mm_and_si128(_mm_srl_epi32(p11, shift), mask);
+    __m128i top = _mm_srai_epi32(_mm_add_epi32(Sse41LerpQ14(c00, c01, wx), round), kHorizShift);
+    __m128i bot = _mm_srai_epi32(_mm_add_epi32(Sse41LerpQ14(c10, c11, wx), round), kHorizShift);
+    return _mm_mul_ps(_mm_cvtepi32_ps(Sse41LerpQ14(top, bot, wy)),
+                      _mm_set1_ps(kOutputScale));
+}
+
+LETTERBOX_TARGET_SSE41
+static void ResampleRowSSE41(const RowArgs& a, int x_begin, int x_end) {
+    const int* r0 = reinterpret_cast<const int*>(a.row0);
+    const int* r1 = reinterpret_cast<const int*>(a.row1);
+    const __m128i vwy = _mm_set1_epi32(a.wy);
+    const __m128i shift_r = _mm_cvtsi32_si128(8);
+    const __m128i shift_g = _mm_cvtsi32_si128(16);
+    const __m128i shift_b = _mm_cvtsi32_si128(24);
+
+    int x = x_begin;
+    for (; x + 4 <= x_end; x += 4) {
+        const int32_t* i0 = a.x0 + x;
+        const int32_t* i1 = a.x1 + x;
+        __m128i wx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a.wx + x));
+
+        // No gather before AVX2 — load the four lanes directly.
+        __m128i p00 = _mm_setr_epi32(r0[i0[0]], r0[i0[1]], r0[i0[2]], r0[i0[3]]);
+        __m128i p01 = _mm_setr_epi32(r0[i1[0]], r0[i1[1]], r0[i1[2]], r0[i1[3]]);
+        __m128i p10 = _mm_setr_epi32(r1[i0[0]], r1[i0[1]], r1[i0[2]], r1[i0[3]]);
+        __m128i p11 = _mm_setr_epi32(r1[i1[0]], r1[i1[1]], r1[i1[2]], r1[i1[3]]);
+
+        _mm_storeu_ps(a.dst_r + x, Sse41Channel(p00, p01, p10, p11, shift_r, wx, vwy));
+        _mm_storeu_ps(a.dst_g + x, Sse41Channel(p00, p01, p10, p11, shift_g, wx, vwy));
+        _mm_storeu_ps(a.dst_b + x, Sse41Channel(p00, p01, p10, p11, shift_b, wx, vwy));
+    }
+    ResampleRowScalar(a, x, x_end);
+}
+#endif // LETTERBOX_X86
+
+#if defined(LETTERBOX_NEON)
+static inline int32x4_t NeonLerpQ14(int32x4_t a, int32x4_t b, int32x4_t w) {
+    return vmlaq_s32(vshlq_n_s32(a, kWeightBits), vsubq_s32(b, a), w);
+}
+
+// Channel bytes are extracted by the caller (vshrq_n needs an immediate).
+static inline float32x4_t NeonChannel(int32x4_t c00, int32x4_t c01,
+                                      int32x4_t c10, int32x4_t c11,
+                                      int32x4_t wx, int32x4_t wy) {
+    int32x4_t top = vrshrq_n_s32(NeonLerpQ14(c00, c01, wx), kHorizShift);
+    int32x4_t bot = vrshrq_n_s32(NeonLerpQ14(c10, c11, wx), kHorizShift);
+    return vmulq_n_f32(vcvtq_f32_s32(NeonLerpQ14(top, bot, wy)), kOutputScale);
+}
+
+static void ResampleRowNEON(const RowArgs& a, int x_begin, int x_end) {
+    const uint32_t* r0 = reinterpret_cast<const uint32_t*>(a.row0);
+    const uint32_t* r1 = reinterpret_cast<const uint32_t*>(a.row1);
+    const int32x4_t  vwy   = vdupq_n_s32(a.wy);
+    const uint32x4_t vmask = vdupq_n_u32(0xFF);
+
+    int x = x_begin;
+    for (; x + 4 <= x_end; x += 4) {
+        const int32_t* i0 = a.x0 + x;
+        const int32_t* i1 = a.x1 + x;
+        int32x4_t wx = vld1q_s32(a.wx + x);
+
+        uint32_t q00[4] = { r0[i0[0]], r0[i0[1]], r0[i0[2]], r0[i0[3]] };
+        uint32_t q01[4] = { r0[i1[0]], r0[i1[1]], r0[i1[2]], r0[i1[3]] };
+        uint32_t q10[4] = { r1[i0[0]], r1[i0[1]], r1[i0[2]], r1[i0[3]] };
+        uint32_t q11[4] = { r1[i1[0]], r1[i1[1]], r1[i1[2]], r1[i1[3]] };
+        uint32x4_t p00 = vld1q_u32(q00), p01 = vld1q_u32(q01);
+        uint32x4_t p10 = vld1q_u32(q10), p11 = vld1q_u32(q11);
+
+#define NEON_BYTE(px, sh) vreinterpretq_s32_u32(vandq_u32(vshrq_n_u32(px, sh), vmask))
+#define NEON_CHANNEL(sh) NeonChannel(NEON_BYTE(p00, sh), NEON_BYTE(p01, sh), \
+                                     NEON_BYTE(p10, sh), NEON_BYTE(p11, sh), wx, vwy)
+        vst1q_f32(a.dst_r + x, NEON_CHANNEL(8));
+        vst1q_f32(a.dst_g + x, NEON_CHANNEL(16));
+        vst1q_f32(a.dst_b + x, NEON_CHANNEL(24));
+#undef NEON_CHANNEL
+#undef NEON_BYTE
+    }
+    ResampleRowScalar(a, x, x_end);
+}
+#endif // LETTERBOX_NEON
+
+// ----------------------------------------------------------------------------
+// 16- and 32-bpc row kernels (float lerp)
+// ----------------------------------------------------------------------------
+template <typename Channel>
+static void ResampleRowFloatScalar(const RowArgs& a, int x_begin, int x_end) {
+    const Channel* r0 = reinterpret_cast<const Channel*>(a.row0);
+    const Channel* r1 = reinterpret_cast<const Channel*>(a.row1);
+    const float scale = 1.0f / ChannelTraits<Channel>::Range();
+    const float wy = static_cast<float>(a.wy) * kWeightScale;
+    float* dst[3] = { a.dst_r, a.dst_g, a.dst_b };
+
+    for (int x = x_begin; x < x_end; x++) {
+        const Channel* p00 = r0 + a.x0[x] * 4;
+        const Channel* p01 = r0 + a.x1[x] * 4;
+        const Channel* p10 = r1 + a.x0[x] * 4;
+        const Channel* p11 = r1 + a.x1[x] * 4;
+        float wx = static_cast<float>(a.wx[x]) * kWeightScale;
+
+        for (int c = 0; c < 3; c++) {
+            int ae_offset = c + 1;
+            float v00 = static_cast<float>(p00[ae_offset]), v01 = static_cast<float>(p01[ae_offset]);
+            float v10 = static_cast<float>(p10[ae_offset]), v11 = static_cast<float>(p11[ae_offset]);
+            float top = v00 + (v01 - v00) * wx;
+            float bot = v10 + (v11 - v10) * wx;
+            dst[c][x] = ChannelTraits<Channel>::Store((top + (bot - top) * wy) * scale);
+        }
+    }
+}
+
+#if defined(LETTERBOX_X86)
+// R, G, B of 8 pixels as floats on the source scale. A PF_Pixel16 is two
+// 32-bit words (A|R<<16, G|B<<16), so two gathers at 8-byte stride cover it.
+LETTERBOX_TARGET_AVX2
+static inline void Avx2GatherRGB(const uint16_t* row, __m256i idx, __m256 rgb[3]) {
+    const int* base = reinterpret_cast<const int*>(row);
+    const __m256i lo = _mm256_set1_epi32(0xFFFF);
+    __m256i ar = _mm256_i32gather_epi32(base, idx, 8);
+    __m256i gb = _mm256_i32gather_epi32(base + 1, idx, 8);
+    rgb[0] = _mm256_cvtepi32_ps(_mm256_srli_epi32(ar, 16));
+    rgb[1] = _mm256_cvtepi32_ps(_mm256_and_si256(gb, lo));
+    rgb[2] = _mm256_cvtepi32_ps(_mm256_srli_epi32(gb, 16));
+}
+
+LETTERBOX_TARGET_AVX2
+static inline void Avx2GatherRGB(const float* row, __m256i idx, __m256 rgb[3]) {
+    __m256i idx4 = _mm256_slli_epi32(idx, 2);   // 4 floats per pixel
+    rgb[0] = _mm256_i32gather_ps(row + 1, idx4, 4);
+    rgb[1] = _mm256_i32gather_ps(row + 2, idx4, 4);
+    rgb[2] = _mm256_i32gather_ps(row + 3, idx4, 4);
+}
+
+LETTERBOX_TARGET_AVX2
+static inline __m256 Avx2LerpF(__m256 a, __m256 b, __m256 w) {
+    return _mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), w));
+}
+
+template <typename Channel>
+LETTERBOX_TARGET_AVX2
+static void ResampleRowFloatAVX2(const RowArgs& a, int x_begin, int x_end) {
+    const Channel* r0 = reinterpret_cast<const Channel*>(a.row0);
+    const Channel* r1 = reinterpret_cast<const Channel*>(a.row1);
+    const __m256 wscale = _mm256_set1_ps(kWeightScale);
+    const __m256 vwy    = _mm256_set1_ps(static_cast<float>(a.wy) * kWeightScale);
+    const __m256 vscale = _mm256_set1_ps(1.0f / ChannelTraits<Channel>::Range());
+    const __m256 zero   = _mm256_setzero_ps();
+    const __m256 one    = _mm256_set1_ps(1.0f);
+    float* dst[3] = { a.dst_r, a.dst_g, a.dst_b };
+
+    int x = x_begin;
+    for (; x + 8 <= x_end; x += 8) {
+        __m256i sx0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a.x0 + x));
+        __m256i sx1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a.x1 + x));
+        __m256  wx  = _mm256_mul_ps(_mm256_cvtepi32_ps(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a.wx + x))), wscale);
+
+        __m256 p00[3], p01[3], p10[3], p11[3];
+        Avx2GatherRGB(r0, sx0, p00);
+        Avx2GatherRGB(r0, sx1, p01);
+        Avx2GatherRGB(r1, sx0, p10);
+        Avx2GatherRGB(r1, sx1, p11);
+
+        for (int c = 0; c < 3; c++) {
+            __m256 top = Avx2LerpF(p00[c], p01[c], wx);
+            __m256 bot = Avx2LerpF(p10[c], p11[c], wx);
+            __m256 v = _mm256_mul_ps(Avx2LerpF(top, bot, vwy), vscale);
+            _mm256_storeu_ps(dst[c] + x, _mm256_min_ps(_mm256_max_ps(v, zero), one));
+        }
+    }
+    ResampleRowFloatScalar<Channel>(a, x, x_end);
+}
+
+template <typename Channel>
+LETTERBOX_TARGET_SSE41
+static inline __m128 Sse41LoadChannel(const Channel* row, const int32_t* idx, int ae_offset) {
+    return _mm_setr_ps(static_cast<float>(row[idx[0] * 4 + ae_offset]),
+                       static_cast<float>(row[idx[1] * 4 + ae_offset]),
+                       static_cast<float>(row[idx[2] * 4 + ae_offset]),
+                       static_cast<float>(row[idx[3] * 4 + ae_offset]));
+}
+
+LETTERBOX_TARGET_SSE41
+static inline __m128 Sse41LerpF(__m128 a, __m128 b, __m128 w) {
+    return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), w));
+}
+
+template <typename Channel>
+LETTERBOX_TARGET_SSE41
+static void ResampleRowFloatSSE41(const RowArgs& a, int x_begin, int x_end) {
+    const Channel* r0 = reinterpret_cast<const Channel*>(a.row0);
+    const Channel* r1 = reinterpret_cast<const Channel*>(a.row1);
+    const __m128 wscale = _mm_set1_ps(kWeightScale);
+    const __m128 vwy    = _mm_set1_ps(static_cast<float>(a.wy) * kWeightScale);
+    const __m128 vscale = _mm_set1_ps(1.0f / ChannelTraits<Channel>::Range());
+    const __m128 zero   = _mm_setzero_ps();
+    const __m128 one    = _mm_set1_ps(1.0f);
+    float* dst[3] = { a.dst_r, a.dst_g, a.dst_b };
+
+    int x = x_begin;
+    for (; x + 4 <= x_end; x += 4) {
+        const int32_t* i0 = a.x0 + x;
+        const int32_t* i1 = a.x1 + x;
+        __m128 wx = _mm_mul_ps(_mm_cvtepi32_ps(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(a.wx + x))), wscale);
+
+        for (int c = 0; c < 3; c++) {
+            __m128 top = Sse41LerpF(Sse41LoadChannel(r0, i0, c + 1), Sse41LoadChannel(r0, i1, c + 1), wx);
+            __m128 bot = Sse41LerpF(Sse41LoadChannel(r1, i0, c + 1), Sse41LoadChannel(r1, i1, c + 1), wx);
+            __m128 v = _mm_mul_ps(Sse41LerpF(top, bot, vwy), vscale);
+            _mm_storeu_ps(dst[c] + x, _mm_min_ps(_mm_max_ps(v, zero), one));
+        }
+    }
+    ResampleRowFloatScalar<Channel>(a, x, x_end);
+}
+#endif // LETTERBOX_X86
+
+#if defined(LETTERBOX_NEON)
+template <typename Channel>
+static inline float32x4_t NeonLoadChannel(const Channel* row, const int32_t* idx, int ae_offset) {
+    float v[4] = { static_cast<float>(row[idx[0] * 4 + ae_offset]),
+                   static_cast<float>(row[idx[1] * 4 + ae_offset]),
+                   static_cast<float>(row[idx[2] * 4 + ae_offset]),
+                   static_cast<float>(row[idx[3] * 4 + ae_offset]) };
+    return vld1q_f32(v);
+}
+
+static inline float32x4_t NeonLerpF(float32x4_t a, float32x4_t b, float32x4_t w) {
+    return vaddq_f32(a, vmulq_f32(vsubq_f32(b, a), w));
+}
+
+template <typename Channel>
+static void ResampleRowFloatNEON(const RowArgs& a, int x_begin, int x_end) {
+    const Channel* r0 = reinterpret_cast<const Channel*>(a.row0);
+    const Channel* r1 = reinterpret_cast<const Channel*>(a.row1);
+    const float32x4_t vwy  = vdupq_n_f32(static_cast<float>(a.wy) * kWeightScale);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t one  = vdupq_n_f32(1.0f);
+    const float scale = 1.0f / ChannelTraits<Channel>::Range();
+    float* dst[3] = { a.dst_r, a.dst_g, a.dst_b };
+
+    int x = x_begin;
+    for (; x + 4 <= x_end; x += 4) {
+        const int32_t* i0 = a.x0 + x;
+        const int32_t* i1 = a.x1 + x;
+        float32x4_t wx = vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(a.wx + x)), kWeightScale);
+
+        for (int c = 0; c < 3; c++) {
+            float32x4_t top = NeonLerpF(NeonLoadChannel(r0, i0, c + 1), NeonLoadChannel(r0, i1, c + 1), wx);
+            float32x4_t bot = NeonLerpF(NeonLoadChannel(r1, i0, c + 1), NeonLoadChannel(r1, i1, c + 1), wx);
+            float32x4_t v = vmulq_n_f32(NeonLerpF(top, bot, vwy), scale);
+            // vmaxnm returns the number when one operand is NaN, like the scalar clamp.
+            vst1q_f32(dst[c] + x, vminq_f32(vmaxnmq_f32(v, zero), one));
+        }
+    }
+    ResampleRowFloatScalar<Channel>(a, x, x_end);
+}
+#endif // LETTERBOX_NEON
+
+typedef void (*ResampleRowFn)(const RowArgs&, int, int);
+
+template <typename Channel>
+static ResampleRowFn SelectRowKernel(LetterboxKernel kernel) {
+    switch (ResolveKernel(kernel)) {
+#if defined(LETTERBOX_X86)
+        case LetterboxKernel::AVX2:  return ResampleRowFloatAVX2<Channel>;
+        case LetterboxKernel::SSE41: return ResampleRowFloatSSE41<Channel>;
+#endif
+#if defined(LETTERBOX_NEON)
+        case LetterboxKernel::NEON:  return ResampleRowFloatNEON<Channel>;
+#endif
+        default:                     return ResampleRowFloatScalar<Channel>;
+    }
+}
+
+template <>
+ResampleRowFn SelectRowKernel<unsigned char>(LetterboxKernel kernel) {
+    switch (ResolveKernel(kernel)) {
+#if defined(LETTERBOX_X86)
+        case LetterboxKernel::AVX2:  return ResampleRowAVX2;
+        case LetterboxKernel::SSE41: return ResampleRowSSE41;
+#endif
+#if defined(LETTERBOX_NEON)
+        case LetterboxKernel::NEON:  return ResampleRowNEON;
+#endif
+        default:                     return ResampleRowScalar;
+    }
+}
+
+// ============================================================================
+// Area kernels
+//
+// Both paths stream each output row's source rows top to bottom and accumulate,
+// so source memory is read sequentially rather than gathered.
+// ============================================================================
+struct AreaArgs {
+    const LetterboxPlan* plan;
+    const unsigned char* src;
+    float* dst_r;               // content pixel 0 of row y_origin; row y
+    float* dst_g;               //   starts (y - y_origin) * stride later
+    float* dst_b;
+    size_t stride;
+    int    y_origin;
+};
+
+// Exact K×K box: channel sums (integer for 8/16-bpc, ≤ 32768·36) scaled once
+// to [0,1].
+template <typename Channel, int K>
+static void AreaRowsBox(const AreaArgs& a, int y_begin, int y_end) {
+    typedef typename ChannelTraits<Channel>::Sum Sum;
+    const LetterboxPlan& plan = *a.plan;
+    const int new_w = plan.new_w;
+    const float norm = 1.0f / (ChannelTraits<Channel>::Range() * K * K);
+    std::vector<Sum> acc(static_cast<size_t>(new_w) * 3);
+
+    for (int y = y_begin; y < y_end; y++) {
+        std::fill(acc.begin(), acc.end(), Sum(0));
+        for (int j = 0; j < K; j++) {
+            const Channel* row = reinterpret_cast<const Channel*>(
+                a.src + static_cast<size_t>(y * K + j) * plan.rowbytes);
+            Sum* out = acc.data();
+            for (int x = 0; x < new_w; x++, row += K * 4, out += 3) {
+                Sum r = 0, g = 0, b = 0;
+                for (int i = 0; i < K; i++) {
+                    r += row[i * 4 + 1];
+                    g += row[i * 4 + 2];
+                    b += row[i * 4 + 3];
+                }
+                out[0] += r;
+                out[1] += g;
+                out[2] += b;
+            }
+        }
+
+        size_t row_off = static_cast<size_t>(y - a.y_origin) * a.stride;
+        float* dr = a.dst_r + row_off;
+        float* dg = a.dst_g + row_off;
+        float* db = a.dst_b + row_off;
+        for (int x = 0; x < new_w; x++) {
+            dr[x] = ChannelTraits<Channel>::Store(static_cast<float>(acc[x * 3 + 0]) * norm);
+            dg[x] = ChannelTraits<Channel>::Store(static_cast<float>(acc[x * 3 + 1]) * norm);
+            db[x] = ChannelTraits<Channel>::Store(static_cast<float>(acc[x * 3 + 2]) * norm);
+        }
+    }
+}
+
+// General box filter from the plan's coverage taps. Same fixed-point budget as
+// bilinear: horizontal Q14 sum rounded to Q8, vertical Q14 sum < 2^30.
+static void AreaRowsGeneral(const AreaArgs& a, int y_begin, int y_end) {
+    const LetterboxPlan& plan = *a.plan;
+    const int new_w = plan.new_w;
+    std::vector<int32_t> acc(static_cast<size_t>(new_w) * 3);
+
+    for (int y = y_begin; y < y_end; y++) {
+        std::fill(acc.begin(), acc.end(), 0);
+        for (int t = plan.row_tap_start[y]; t < plan.row_tap_start[y + 1]; t++) {
+            const unsigned char* row =
+                a.src + static_cast<size_t>(plan.row_tap_index[t]) * plan.rowbytes;
+            const int32_t wy = plan.row_tap_weight[t];
+            int32_t* out = acc.data();
+            for (int x = 0; x < new_w; x++, out += 3) {
+                int32_t r = 0, g = 0, b = 0;
+                for (int k = plan.col_tap_start[x]; k < plan.col_tap_start[x + 1]; k++) {
+                    const unsigned char* p = row + plan.col_tap_index[k] * 4;
+                    int32_t wx = plan.col_tap_weight[k];
+                    r += p[1] * wx;
+                    g += p[2] * wx;
+                    b += p[3] * wx;
+                }
+                out[0] += ((r + kHorizRound) >> kHorizShift) * wy;
+                out[1] += ((g + kHorizRound) >> kHorizShift) * wy;
+                out[2] += ((b + kHorizRound) >> kHorizShift) * wy;
+            }
+        }
+
+        size_t row_off = static_cast<size_t>(y - a.y_origin) * a.stride;
+        float* dr = a.dst_r + row_off;
+        float* dg = a.dst_g + row_off;
+        float* db = a.dst_b + row_off;
+        for (int x = 0; x < new_w; x++) {
+            dr[x] = static_cast<float>(acc[x * 3 + 0]) * kOutputScale;
+            dg[x] = static_cast<float>(acc[x * 3 + 1]) * kOutputScale;
+            db[x] = static_cast<float>(acc[x * 3 + 2]) * kOutputScale;
+        }
+    }
+}
+
+// 16- and 32-bpc general box filter: the same coverage taps, accumulated in
+// float on the source scale.
+template <typename Channel>
+static void AreaRowsGeneralFloat(const AreaArgs& a, int y_begin, int y_end) {
+    const LetterboxPlan& plan = *a.plan;
+    const int new_w = plan.new_w;
+    const float scale = 1.0f / ChannelTraits<Channel>::Range();
+    std::vector<float> acc(static_cast<size_t>(new_w) * 3);
+
+    for (int y = y_begin; y < y_end; y++) {
+        std::fill(acc.begin(), acc.end(), 0.0f);
+        for (int t = plan.row_tap_start[y]; t < plan.row_tap_start[y + 1]; t++) {
+            const Channel* row = reinterpret_cast<const Channel*>(
+                a.src + static_cast<size_t>(plan.row_tap_index[t]) * plan.rowbytes);
+            const float wy = static_cast<float>(plan.row_tap_weight[t]) * kWeightScale;
+            float* out = acc.data();
+            for (int x = 0; x < new_w; x++, out += 3) {
+                float r = 0.0f, g = 0.0f, b = 0.0f;
+                for (int k = plan.col_tap_start[x]; k < plan.col_tap_start[x + 1]; k++) {
+                    const Channel* p = row + plan.col_tap_index[k] * 4;
+                    float wx = static_cast<float>(plan.col_tap_weight[k]) * kWeightScale;
+                    r += static_cast<float>(p[1]) * wx;
+                    g += static_cast<float>(p[2]) * wx;
+                    b += static_cast<float>(p[3]) * wx;
+                }
+                out[0] += r * wy;
+                out[1] += g * wy;
+                out[2] += b * wy;
+            }
+        }
+
+        size_t row_off = static_cast<size_t>(y - a.y_origin) * a.stride;
+        float* dr = a.dst_r + row_off;
+        float* dg = a.dst_g + row_off;
+        float* db = a.dst_b + row_off;
+        for (int x = 0; x < new_w; x++) {
+            dr[x] = ChannelTraits<Channel>::Store(acc[x * 3 + 0] * scale);
+            dg[x] = ChannelTraits<Channel>::Store(acc[x * 3 + 1] * scale);
+            db[x] = ChannelTraits<Channel>::Store(acc[x * 3 + 2] * scale);
+        }
+    }
+}
+
+typedef void (*AreaRowsFn)(const AreaArgs&, int, int);
+
+template <typename Channel>
+static AreaRowsFn SelectAreaKernel(int ratio) {
+    switch (ratio) {
+        case 2:  return AreaRowsBox<Channel, 2>;
+        case 3:  return AreaRowsBox<Channel, 3>;
+        case 4:  return AreaRowsBox<Channel, 4>;
+        case 6:  return AreaRowsBox<Channel, 6>;
+        default: return AreaRowsGeneralFloat<Channel>;
+    }
+}
+
+template <>
+AreaRowsFn SelectAreaKernel<unsigned char>(int ratio) {
+    switch (ratio) {
+        case 2:  return AreaRowsBox<unsigned char, 2>;
+        case 3:  return AreaRowsBox<unsigned char, 3>;
+        case 4:  return AreaRowsBox<unsigned char, 4>;
+        case 6:  return AreaRowsBox<unsigned char, 6>;
+        default: return AreaRowsGeneral;
+    }
+}
+
+// ============================================================================
+// LetterboxPreprocess
+// ============================================================================
+// Resampled content for one band: the source, the plan and the kernels picked
+// for them.
+struct ContentArgs {
+    const LetterboxPlan* plan;
+    const unsigned char* src;
+    ResampleRowFn        resample_row;
+    AreaRowsFn           area_rows;
+};
+
+// Content rows [y_begin, y_end) into float rows; dst[c] is channel c's first
+// content pixel of row y_begin and rows are `stride` floats apart.
+static void ResampleContent(const ContentArgs& c, float* const dst[3], size_t stride,
+                            int y_begin, int y_end) {
+    const LetterboxPlan& plan = *c.plan;
+    if (plan.filter == LetterboxFilter::Area) {
+        AreaArgs area;
+        area.plan     = &plan;
+        area.src      = c.src;
+        area.dst_r    = dst[0];
+        area.dst_g    = dst[1];
+        area.dst_b    = dst[2];
+        area.stride   = stride;
+        area.y_origin = y_begin;
+        c.area_rows(area, y_begin, y_end);
+        return;
+    }
+
+    RowArgs args;
+    args.x0 = plan.col_x0.data();
+    args.x1 = plan.col_x1.data();
+    args.wx = plan.col_wx.data();
+
+    for (int y = y_begin; y < y_end; y++) {
+        size_t row_off = static_cast<size_t>(y - y_begin) * stride;
+        args.row0  = c.src + plan.row_off0[y];
+        args.row1  = c.src + plan.row_off1[y];
+        args.wy    = plan.row_wy[y];
+        args.dst_r = dst[0] + row_off;
+        args.dst_g = dst[1] + row_off;
+        args.dst_b = dst[2] + row_off;
+        c.resample_row(args, 0, plan.new_w);
+    }
+}
+
+// Float planes: the kernels write the output rows in place.
+static void WriteContentRows(const ContentArgs& c, float* const planes[3], int y_begin, int y_end) {
+    const LetterboxPlan& plan = *c.plan;
+    size_t off = static_cast<size_t>(plan.pad_top + y_begin) * plan.target_w + plan.pad_left;
+    float* dst[3] = { planes[0] + off, planes[1] + off, planes[2] + off };
+    ResampleContent(c, dst, plan.target_w, y_begin, y_end);
+}
+
+// Half planes: resample a few rows into band-local float scratch that stays
+// in L1/L2, then narrow them into the output.
+static void WriteContentRows(const ContentArgs& c, Float16* const planes[3], int y_begin, int y_end) {
+    const int kChunkRows = 8;
+    const LetterboxPlan& plan = *c.plan;
+    const size_t new_w = static_cast<size_t>(plan.new_w);
+    std::vector<float> scratch(new_w * kChunkRows * 3);
+    float* dst[3] = { scratch.data(),
+                      scratch.data() + new_w * kChunkRows,
+                      scratch.data() + new_w * kChunkRows * 2 };
+
+    for (int y = y_begin; y < y_end; y += kChunkRows) {
+        int rows = std::min(kChunkRows, y_end - y);
+        ResampleContent(c, dst, new_w, y, y + rows);
+        for (int r = 0; r < rows; r++) {
+            size_t off = static_cast<size_t>(plan.pad_top + y + r) * plan.target_w + plan.pad_left;
+            for (int ch = 0; ch < 3; ch++) {
+                const float* in = dst[ch] + r * new_w;
+                Float16* out = planes[ch] + off;
+                for (size_t x = 0; x < new_w; x++) out[x] = Float16(in[x]);
+            }
+        }
+    }
+}
+
+// Split the plan's content rows into bands on the shared worker pool. Bands
+// narrower than kMinBandRows cost more in wake-ups than they save.
+template <typename Fn>
+static void ForEachRowBand(const LetterboxPlan& plan, int num_threads, Fn&& process_rows) {
+    const int kMinBandRows = 32;
+    ThreadPool& pool = ThreadPool::Shared();
+    int max_bands = num_threads > 0 ? num_threads : pool.NumWorkers() + 1;
+    int bands = std::min(max_bands, std::max(1, plan.new_h / kMinBandRows));
+    pool.ParallelFor(plan.new_h, bands, process_rows);
+}
+
+template <typename Channel>
+static ContentArgs MakeContentArgs(const LetterboxPlan& plan, const Channel* argb_pixels,
+                                   LetterboxKernel kernel) {
+    // Kernels address rows by byte offset (rowbytes) and cast per channel type.
+    ContentArgs content;
+    content.plan         = &plan;
+    content.src          = reinterpret_cast<const unsigned char*>(argb_pixels);
+    content.resample_row = SelectRowKernel<Channel>(kernel);
+    content.area_rows    = SelectAreaKernel<Channel>(plan.area_ratio);
+    return content;
+}
+
+template <typename Channel, typename Out>
+LetterboxInfo LetterboxPreprocess(
+    const LetterboxPlan& plan,
+    const Channel* argb_pixels,
+    std::vector<Out>& output_chw,
+    LetterboxKernel kernel,
+    int num_threads)
+{
+    const int target_w = plan.target_w;
+
+    // output_chw is provided by caller; resize only if needed
+    size_t total = static_cast<size_t>(target_w) * plan.target_h;
+    if (output_chw.size() != total * 3)
+        output_chw.resize(total * 3);
+
+    Out* planes[3] = {
+        output_chw.data(),              // R
+        output_chw.data() + total,      // G
+        output_chw.data() + total * 2   // B
+    };
+
+    // Only the padding bands get the 114 gray; the content area is written
+    // exactly once by the row kernel below.
+    const Out pad_value = Out(114.0f / 255.0f);
+    size_t top_band    = static_cast<size_t>(plan.pad_top) * target_w;
+    size_t bottom_from = static_cast<size_t>(plan.pad_top + plan.new_h) * target_w;
+    int right_from     = plan.pad_left + plan.new_w;
+    for (Out* plane : planes) {
+        std::fill(plane, plane + top_band, pad_value);
+        std::fill(plane + bottom_from, plane + total, pad_value);
+    }
+
+    const ContentArgs content = MakeContentArgs(plan, argb_pixels, kernel);
+
+    // Each band owns its output rows and private scratch, so bands share
+    // nothing mutable and this function is re-entrant.
+    auto process_rows = [&](int y_begin, int y_end) {
+        for (int y = y_begin; y < y_end; y++) {
+            size_t row_off = static_cast<size_t>(plan.pad_top + y) * target_w;
+            for (Out* plane : planes) {
+                std::fill(plane + row_off, plane + row_off + plan.pad_left, pad_value);
+                std::fill(plane + row_off + right_from, plane + row_off + target_w, pad_value);
+            }
+        }
+        WriteContentRows(content, planes, y_begin, y_end);
+    };
+    ForEachRowBand(plan, num_threads, process_rows);
+
+    return plan.info;
+}
+
+template LetterboxInfo LetterboxPreprocess<unsigned char, float>(
+    const LetterboxPlan&, const unsigned char*, std::vector<float>&, LetterboxKernel, int);
+template LetterboxInfo LetterboxPreprocess<uint16_t, float>(
+    const LetterboxPlan&, const uint16_t*, std::vector<float>&, LetterboxKernel, int);
+template LetterboxInfo LetterboxPreprocess<float, float>(
+    const LetterboxPlan&, const float*, std::vector<float>&, LetterboxKernel, int);
+template LetterboxInfo LetterboxPreprocess<unsigned char, Float16>(
+    const LetterboxPlan&, const unsigned char*, std::vector<Float16>&, LetterboxKernel, int);
+template LetterboxInfo LetterboxPreprocess<uint16_t, Float16>(
+    const LetterboxPlan&, const uint16_t*, std::vector<Float16>&, LetterboxKernel, int);
+template LetterboxInfo LetterboxPreprocess<float, Float16>(
+    const LetterboxPlan&, const float*, std::vector<Float16>&, LetterboxKernel, int);
+
+template <typename Channel>
+LetterboxInfo LetterboxPreprocessRGB8(
+    const LetterboxPlan& plan,
+    const Channel* argb_pixels,
+    std::vector<unsigned char>& output_hwc,
+    LetterboxKernel kernel,
+    int num_threads)
+{
+    const int target_w = plan.target_w;
+    const size_t row_bytes = static_cast<size_t>(target_w) * 3;
+    size_t total = row_bytes * plan.target_h;
+    if (output_hwc.size() != total)
+        output_hwc.resize(total);
+    unsigned char* out = output_hwc.data();
+
+    // 114 is the pad byte itself, so gray padding is a plain memset.
+    const unsigned char pad_value = 114;
+    size_t top_band    = static_cast<size_t>(plan.pad_top) * row_bytes;
+    size_t bottom_from = static_cast<size_t>(plan.pad_top + plan.new_h) * row_bytes;
+    std::fill(out, out + top_band, pad_value);
+    std::fill(out + bottom_from, out + total, pad_value);
+
+    const ContentArgs content = MakeContentArgs(plan, argb_pixels, kernel);
+
+    // Same float kernels as the CHW path, a few rows at a time into band-local
+    // scratch, then rounded and interleaved into the output rows.
+    auto process_rows = [&](int y_begin, int y_end) {
+        const int kChunkRows = 8;
+        const size_t new_w = static_cast<size_t>(plan.new_w);
+        std::vector<float> scratch(new_w * kChunkRows * 3);
+        float* dst[3] = { scratch.data(),
+                          scratch.data() + new_w * kChunkRows,
+                          scratch.data() + new_w * kChunkRows * 2 };
+
+        for (int y = y_begin; y < y_end; y += kChunkRows) {
+            int rows = std::min(kChunkRows, y_end - y);
+            ResampleContent(content, dst, new_w, y, y + rows);
+            for (int r = 0; r < rows; r++) {
+                unsigned char* row = out + static_cast<size_t>(plan.pad_top + y + r) * row_bytes;
+                std::fill(row, row + static_cast<size_t>(plan.pad_left) * 3, pad_value);
+                std::fill(row + static_cast<size_t>(plan.pad_left + plan.new_w) * 3, row + row_bytes,
+                          pad_value);
+
+                const float* in_r = dst[0] + r * new_w;
+                const float* in_g = dst[1] + r * new_w;
+                const float* in_b = dst[2] + r * new_w;
+                unsigned char* px = row + static_cast<size_t>(plan.pad_left) * 3;
+                for (size_t x = 0; x < new_w; x++, px += 3) {
+                    // Kernel output is already clamped to [0,1].
+                    px[0] = static_cast<unsigned char>(in_r[x] * 255.0f + 0.5f);
+                    px[1] = static_cast<unsigned char>(in_g[x] * 255.0f + 0.5f);
+                    px[2] = static_cast<unsigned char>(in_b[x] * 255.0f + 0.5f);
+                }
+            }
+        }
+    };
+    ForEachRowBand(plan, num_threads, process_rows);
+
+    return plan.info;
+}
+
+template LetterboxInfo LetterboxPreprocessRGB8<unsigned char>(
+    const LetterboxPlan&, const unsigned char*, std::vector<unsigned char>&, LetterboxKernel, int);
+template LetterboxInfo LetterboxPreprocessRGB8<uint16_t>(
+    const LetterboxPlan&, const uint16_t*, std::vector<unsigned char>&, LetterboxKernel, int);
+template LetterboxInfo LetterboxPreprocessRGB8<float>(
+    const LetterboxPlan&, const float*, std::vector<unsigned char>&, LetterboxKernel, int);
+
+LetterboxInfo LetterboxPreprocess(
+    const unsigned char* argb_pixels,
+    int width, int height, int rowbytes,
+    int target_size,
+    std::vector<float>& output_chw,
+    LetterboxKernel kernel,
+    int num_threads)
+{
+    LetterboxPlan plan = BuildLetterboxPlan(width, height, rowbytes, target_size);
+    return LetterboxPreprocess(plan, argb_pixels, output_chw, kernel, num_threads);
+}
@@ -3,6 +3,10 @@
 #include <vector>
 #include <cmath>
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "Float16.h"
 
 // Letterbox preprocessing info (needed to remap coordinates back)
 struct LetterboxInfo {
@@ -11,101 +15,224 @@ struct LetterboxInfo {
     float pad_y;        // Top padding in pixels (in model input space)
     int orig_w;         // Original image width
     int orig_h;         // Original image height
-    int input_size;     // Model input size (e.g. 640)
+    int input_w;        // Model input width (e.g. 640)
+    int input_h;        // Model input height (640, or less for a wide frame)
+    float crop_x;       // Origin of the letterboxed region in original image
+    float crop_y;       //   space (0, 0 unless a tracking crop was used)
+};
+
+// Sub-rectangle of a frame, in pixels.
+struct LetterboxCropRect {
+    int x, y, w, h;
+};
+
+// Resample kernel selection. Auto picks the widest SIMD path the CPU supports;
+// Scalar is the reference implementation every SIMD path is tested against.
+enum class LetterboxKernel {
+    Auto = 0,
+    Scalar,
+    SSE41,
+    AVX2,
+    NEON
+};
+
+// True if the given kernel can run on this CPU (Auto and Scalar always can).
+bool LetterboxKernelSupported(LetterboxKernel kernel);
+
+// Resize filter. Auto uses Area when downscaling below 0.5x (e.g. 4K → 640),
+// where bilinear's 4 taps alias and hop randomly through the source, and
+// Bilinear otherwise.
+enum class LetterboxFilter {
+    Auto = 0,
+    Bilinear,
+    Area
+};
+
+// Precomputed resample tables for one frame geometry. Width, height, rowbytes
+// and target shape never change within an Analyze run, so the plan is built
+// once and every frame's inner loop is just table loads and integer
+// multiply-adds (Q14 fixed-point weights, no divisions or float→int casts).
+// Indices are in pixels and row offsets in bytes, so one plan serves any
+// channel depth.
+struct LetterboxPlan {
+    LetterboxInfo info = {};
+    int src_w = 0, src_h = 0, rowbytes = 0;
+    int target_w = 0, target_h = 0;    // model input tensor width and height
+    int new_w = 0, new_h = 0;          // resized content size
+    int pad_left = 0, pad_top = 0;     // content placement in the target
+    LetterboxFilter filter = LetterboxFilter::Bilinear;   // resolved, never Auto
+
+    // Bilinear — per output column: source pixel indices and Q14 weight of the
+    // right pixel; per output row: source row byte offsets and Q14 weight of
+    // the lower row.
+    std::vector<int32_t> col_x0, col_x1, col_wx;
+    std::vector<size_t>  row_off0, row_off1;
+    std::vector<int32_t> row_wy;
+
+    // Area — integer box ratio for the exact k×k fast path (2, 3, 4 or 6;
+    // 0 = general), and per-axis box taps for the general path: output i
+    // averages source pixels tap_index[tap_start[i] .. tap_start[i+1]) with Q14
+    // coverage weights that sum to exactly 1.
+    int area_ratio = 0;
+    std::vector<int32_t> col_tap_start, col_tap_index, col_tap_weight;
+    std::vector<int32_t> row_tap_start, row_tap_index, row_tap_weight;
+
+    bool Matches(int width, int height, int row_bytes, int tw, int th) const {
+        return src_w == width && src_h == height && rowbytes == row_bytes &&
+               target_w == tw && target_h == th;
+    }
+    bool Matches(int width, int height, int row_bytes, int target) const {
+        return Matches(width, height, row_bytes, target, target);
+    }
 };
 
-// Letterbox resize: scale + pad to target_size x target_size, then convert HWC→CHW.
-// Input: ARGB 8-bit pixels (PF_Pixel8 layout: alpha, red, green, blue).
-// Output: CHW float [0,1] of size [3 * target_size * target_size].
-inline LetterboxInfo LetterboxPreprocess(
+// Build the resample tables for a (width, height, rowbytes) frame letterboxed
+// into a target_w x target_h model input.
+LetterboxPlan BuildLetterboxPlan(int width, int height, int rowbytes,
+                                 int target_w, int target_h,
+                                 LetterboxFilter filter = LetterboxFilter::Auto);
+
+// Square target_size x target_size input (fixed-shape models).
+inline LetterboxPlan BuildLetterboxPlan(int width, int height, int rowbytes, int target_size,
+                                        LetterboxFilter filter = LetterboxFilter::Auto) {
+    return BuildLetterboxPlan(width, height, rowbytes, target_size, target_size, filter);
+}
+
+// Letterbox resize: scale + pad to target_w x target_h, written straight
+// into CHW planes in a single pass (no HWC scratch, padding bands only).
+// Input: ARGB pixels in AE layout (alpha, red, green, blue) whose geometry
+// matches the plan. Channel is the AE channel type and is instantiated for:
+//   unsigned char — PF_Pixel8, 0..255
+//   uint16_t      — PF_Pixel16, 0..32768 (AE's 16-bpc range)
+//   float         — PF_PixelFloat, nominally 0..1
+// Output: CHW [0,1] of size [3 * target_h * target_w]. 16- and
+// 32-bpc sources are resampled in float, so no precision is lost to an 8-bit
+// conversion; float values outside [0,1] (super-whites, negatives) are
+// clamped to the range the model was trained on after filtering.
+// Out is float, or Float16 for FP16 models: half planes are written straight
+// from the float kernels a few rows at a time, so no full-size float tensor
+// is built and converted afterwards.
+// Rows are processed in bands on the shared worker pool; num_threads caps the
+// number of bands (0 = one per hardware thread, 1 = run on the caller only).
+// `kernel` selects the bilinear row kernel; the Area filter streams source
+// rows through portable loops.
+template <typename Channel, typename Out>
+LetterboxInfo LetterboxPreprocess(
+    const LetterboxPlan& plan,
+    const Channel* argb_pixels,
+    std::vector<Out>& output_chw,
+    LetterboxKernel kernel = LetterboxKernel::Auto,
+    int num_threads = 0);
+
+// Same resampling for models whose input is uint8 NHWC RGB with the /255 and
+// the CHW transpose folded into the graph (tools/fold_uint8_input.py).
+// Output: HWC bytes of size [target_h * target_w * 3], gray 114 padding, each
+// value the float output rounded to the nearest 1/255 step. The model's
+// input tensor is a quarter the size of the float one.
+template <typename Channel>
+LetterboxInfo LetterboxPreprocessRGB8(
+    const LetterboxPlan& plan,
+    const Channel* argb_pixels,
+    std::vector<unsigned char>& output_hwc,
+    LetterboxKernel kernel = LetterboxKernel::Auto,
+    int num_threads = 0);
+
+// Convenience overload that builds a throwaway plan for a single frame.
+LetterboxInfo LetterboxPreprocess(
     const unsigned char* argb_pixels,   // ARGB 8-bit pixel data
     int width, int height, int rowbytes,
     int target_size,
-    std::vector<float>& output_chw)
-{
-    LetterboxInfo info;
-    info.orig_w = width;
-    info.orig_h = height;
-    info.input_size = target_size;
-
-    // Calculate scale and padding
-    info.scale = std::min(
-        static_cast<float>(target_size) / width,
-        static_cast<float>(target_size) / height);
-    int new_w = static_cast<int>(std::round(width * info.scale));
-    int new_h = static_cast<int>(std::round(height * info.scale));
-
-    // Use integer division so placement (pad_left/pad_top) and remapping
-    // (info.pad_x/pad_y) always agree — avoids sub-pixel systematic error.
-    int pad_left = (target_size - new_w) / 2;
-    int pad_top  = (target_size - new_h) / 2;
-    info.pad_x = static_cast<float>(pad_left);
-    info.pad_y = static_cast<float>(pad_top);
-
-    // Reusable scratch buffer — avoids per-frame heap allocation.
-    // Sized for the largest expected input (target_size × target_size × 3).
-    static std::vector<float> hwc;
-    size_t total = static_cast<size_t>(target_size) * target_size;
-    hwc.assign(total * 3, 114.0f / 255.0f);
-
-    // Bilinear interpolation: resize original into center of padded buffer
-    for (int y = 0; y < new_h; y++) {
-        float src_y = y / info.scale;
-        int sy0 = static_cast<int>(src_y);
-        int sy1 = std::min(sy0 + 1, height - 1);
-        float fy = src_y - sy0;
-
-        for (int x = 0; x < new_w; x++) {
-            float src_x = x / info.scale;
-            int sx0 = static_cast<int>(src_x);
-            int sx1 = std::min(sx0 + 1, width - 1);
-            float fx = src_x - sx0;
-
-            // AE pixel layout: ARGB (alpha at offset 0, red at 1, green at 2, blue at 3)
-            const unsigned char* p00 = argb_pixels + sy0 * rowbytes + sx0 * 4;
-            const unsigned char* p01 = argb_pixels + sy0 * rowbytes + sx1 * 4;
-            const unsigned char* p10 = argb_pixels + sy1 * rowbytes + sx0 * 4;
-            const unsigned char* p11 = argb_pixels + sy1 * rowbytes + sx1 * 4;
-
-            for (int c = 0; c < 3; c++) {
-                int ae_offset = c + 1; // skip alpha: R=1, G=2, B=3
-                float v00 = p00[ae_offset] / 255.0f;
-                float v01 = p01[ae_offset] / 255.0f;
-                float v10 = p10[ae_offset] / 255.0f;
-                float v11 = p11[ae_offset] / 255.0f;
-
-                float val = v00 * (1 - fx) * (1 - fy) +
-                            v01 * fx * (1 - fy) +
-                            v10 * (1 - fx) * fy +
-                            v11 * fx * fy;
-
-                int dst_y = pad_top + y;
-                int dst_x = pad_left + x;
-                hwc[(dst_y * target_size + dst_x) * 3 + c] = val;
-            }
-        }
-    }
+    std::vector<float>& output_chw,
+    LetterboxKernel kernel = LetterboxKernel::Auto,
+    int num_threads = 0);
 
-    // Convert HWC → CHW (output_chw is provided by caller; resize only if needed)
-    if (output_chw.size() != total * 3)
-        output_chw.resize(total * 3);
-    for (int y = 0; y < target_size; y++) {
-        for (int x = 0; x < target_size; x++) {
-            size_t px = y * target_size + x;
-            output_chw[0 * total + px] = hwc[px * 3 + 0]; // R
-            output_chw[1 * total + px] = hwc[px * 3 + 1]; // G
-            output_chw[2 * total + px] = hwc[px * 3 + 2]; // B
-        }
+// Smallest model input for a src_w x src_h frame on a model with dynamic H/W:
+// the long side is max_size and the short side is the scaled frame rounded up
+// to a multiple of `stride` (the network's total downsampling, 32 for YOLO),
+// so a 1920x1080 frame at 640 gets 640x384 instead of 640x640 and the network
+// skips the ~40% of the square that would only be padding.
+inline void LetterboxInputShape(int src_w, int src_h, int max_size, int stride,
+                                int& input_w, int& input_h) {
+    input_w = input_h = max_size;
+    if (src_w <= 0 || src_h <= 0 || max_size <= 0 || stride <= 0) return;
+    float scale = std::min(static_cast<float>(max_size) / src_w,
+                           static_cast<float>(max_size) / src_h);
+    auto fit = [&](int side) {
+        int scaled = static_cast<int>(std::lround(side * scale));
+        int aligned = (scaled + stride - 1) / stride * stride;
+        return std::max(std::min(stride, max_size), std::min(aligned, max_size));
+    };
+    input_w = fit(src_w);
+    input_h = fit(src_h);
+}
+
+// Largest integer AE downsample factor that still renders a src_w x src_h
+// layer at or above the model input size on its long side (1 = full res).
+// Letterboxing only ever keeps input_size pixels along that side, so rendering
+// more than that is wasted work.
+inline int LetterboxDownsampleFactor(int src_w, int src_h, int input_size) {
+    if (src_w <= 0 || src_h <= 0 || input_size <= 0) return 1;
+    return std::max(1, std::max(src_w, src_h) / input_size);
+}
+
+// Rescale info from a frame rendered at 1/factor so LetterboxRemap returns
+// full-resolution layer coordinates. AE maps downsampled pixel i to layer
+// pixel i * factor (the same convention it uses for point params), so only
+// the scale and original size change; the padding stays in model space.
+inline LetterboxInfo LetterboxToFullRes(const LetterboxInfo& info, int factor,
+                                        int full_w, int full_h) {
+    LetterboxInfo out = info;
+    if (factor > 1) {
+        out.scale = info.scale / static_cast<float>(factor);
+        out.crop_x = info.crop_x * factor;
+        out.crop_y = info.crop_y * factor;
+        out.orig_w = full_w;
+        out.orig_h = full_h;
     }
+    return out;
+}
+
+// Rebase info from letterboxing `crop` of a frame_w x frame_h frame so
+// LetterboxRemap returns frame coordinates (clamped to the whole frame).
+inline LetterboxInfo LetterboxToCrop(const LetterboxInfo& info, const LetterboxCropRect& crop,
+                                     int frame_w, int frame_h) {
+    LetterboxInfo out = info;
+    out.crop_x = info.crop_x + static_cast<float>(crop.x);
+    out.crop_y = info.crop_y + static_cast<float>(crop.y);
+    out.orig_w = frame_w;
+    out.orig_h = frame_h;
+    return out;
+}
 
-    return info;
+// Square crop around a detection box (x1, y1)-(x2, y2), grown by `margin`
+// times the box's long side on every side, rounded up to a multiple of
+// `quantum` pixels (so a steady subject keeps the same crop size and the
+// letterbox plan is reused) and shifted/clamped to stay inside the frame.
+// Returns false when the crop would cover at least half the frame, where
+// letterboxing the full frame loses little and is safer.
+inline bool LetterboxCropAround(float x1, float y1, float x2, float y2, float margin,
+                                int frame_w, int frame_h, int quantum,
+                                LetterboxCropRect& crop) {
+    if (frame_w <= 0 || frame_h <= 0 || !(x2 > x1) || !(y2 > y1)) return false;
+    float side = std::max(x2 - x1, y2 - y1) * (1.0f + 2.0f * margin);
+    int q = std::max(1, quantum);
+    int size = (static_cast<int>(std::ceil(side)) + q - 1) / q * q;
+    crop.w = std::min(size, frame_w);
+    crop.h = std::min(size, frame_h);
+    if (static_cast<double>(crop.w) * crop.h * 2.0 >= static_cast<double>(frame_w) * frame_h)
+        return false;
+    int cx = static_cast<int>(std::lround((x1 + x2) * 0.5f));
+    int cy = static_cast<int>(std::lround((y1 + y2) * 0.5f));
+    crop.x = std::max(0, std::min(cx - crop.w / 2, frame_w - crop.w));
+    crop.y = std::max(0, std::min(cy - crop.h / 2, frame_h - crop.h));
+    return true;
 }
 
 // Remap a coordinate from model input space back to original image space
 inline void LetterboxRemap(const LetterboxInfo& info, float model_x, float model_y,
                             float& orig_x, float& orig_y) {
-    orig_x = (model_x - info.pad_x) / info.scale;
-    orig_y = (model_y - info.pad_y) / info.scale;
+    orig_x = (model_x - info.pad_x) / info.scale + info.crop_x;
+    orig_y = (model_y - info.pad_y) / info.scale + info.crop_y;
     // Clamp to image bounds
     orig_x = std::max(0.0f, std::min(orig_x, static_cast<float>(info.orig_w - 1)));
     orig_y = std::max(0.0f, std::min(orig_y, static_cast<float>(info.orig_h - 1)));
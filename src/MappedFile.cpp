@@ -0,0 +1,68 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+std::unique_ptr<MappedFile> MappedFile::Open(const std::filesystem::path& file) {
+    // FILE_SHARE_DELETE so the model cache can still rename or remove the
+    // entry while it is mapped.
+    HANDLE handle = CreateFileW(file.c_str(), GENERIC_READ,
+                                FILE_SHARE_READ | FILE_SHARE_DELETE, NULL,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (handle == INVALID_HANDLE_VALUE) return nullptr;
+
+    LARGE_INTEGER file_size = {};
+    HANDLE mapping = NULL;
+    if (GetFileSizeEx(handle, &file_size) && file_size.QuadPart > 0)
+        mapping = CreateFileMappingW(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(handle);   // the mapping keeps the file open
+    if (!mapping) return nullptr;
+
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);  // and the view keeps the mapping alive
+    if (!view) return nullptr;
+
+    std::unique_ptr<MappedFile> mapped(new MappedFile());
+    mapped->data_ = view;
+    mapped->size_ = static_cast<size_t>(file_size.QuadPart);
+    return mapped;
+}
+
+MappedFile::~MappedFile() {
+    if (data_) UnmapViewOfFile(data_);
+}
+
+#else
+
+std::unique_ptr<MappedFile> MappedFile::Open(const std::filesystem::path& file) {
+    int fd = open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return nullptr;
+
+    struct stat st = {};
+    void* view = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+        view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);   // the mapping keeps the file open
+    if (view == MAP_FAILED) return nullptr;
+
+    std::unique_ptr<MappedFile> mapped(new MappedFile());
+    mapped->data_ = view;
+    mapped->size_ = static_cast<size_t>(st.st_size);
+    return mapped;
+}
+
+MappedFile::~MappedFile() {
+    if (data_) munmap(const_cast<void*>(data_), size_);
+}
+
+#endif
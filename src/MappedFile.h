@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+
+// Read-only memory map of a whole file. The pages come from the OS page
+// cache, so every session and every process mapping the same file shares one
+// resident copy, and nothing is read until it is touched.
+//
+// The file must not be modified in place while mapped (a truncated mapping
+// faults on access). Model cache entries are only ever replaced by renaming a
+// new file over them, which leaves existing maps on the old contents.
+class MappedFile {
+public:
+    // Map file, or return null if it cannot be opened or is empty.
+    static std::unique_ptr<MappedFile> Open(const std::filesystem::path& file);
+
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const void* data() const { return data_; }
+    size_t      size() const { return size_; }
+
+private:
+    MappedFile() = default;
+
+    const void* data_ = nullptr;
+    size_t      size_ = 0;
+};
@@ -0,0 +1,191 @@
+#include "ModelCache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+static const char* const kEntryExtension = ".ort";
+
+// Per-user cache root, or empty if no suitable directory is known.
+static fs::path CacheDirectory() {
+    if (const char* dir = std::getenv("AE_YOLO_MODEL_CACHE_DIR")) {
+        if (*dir) return fs::u8path(dir);
+    }
+#ifdef _WIN32
+    if (const wchar_t* local = _wgetenv(L"LOCALAPPDATA")) {
+        if (*local) return fs::path(local) / L"AE_YOLO" / L"ModelCache";
+    }
+#elif defined(__APPLE__)
+    if (const char* home = std::getenv("HOME")) {
+        if (*home) return fs::path(home) / "Library" / "Caches" / "AE_YOLO";
+    }
+#else
+    if (const char* xdg = std::getenv("XDG_CACHE_HOME")) {
+        if (*xdg) return fs::path(xdg) / "AE_YOLO";
+    }
+    if (const char* home = std::getenv("HOME")) {
+        if (*home) return fs::path(home) / ".cache" / "AE_YOLO";
+    }
+#endif
+    return fs::path();
+}
+
+static bool CacheEnabled() {
+    const char* value = std::getenv("AE_YOLO_MODEL_CACHE");
+    return !value || !*value || std::atoi(value) != 0;
+}
+
+uint64_t ModelCache::HashFile(const fs::path& file) {
+    std::ifstream in(file, std::ios::binary);
+    if (!in) return 0;
+
+    // FNV-1a, fed 1 MB at a time. Not cryptographic: it only has to notice
+    // that a model file was replaced.
+    uint64_t hash = 1469598103934665603ull;
+    std::vector<char> buf(1 << 20);
+    while (in) {
+        in.read(buf.data(), static_cast<std::streamsize>(buf.size()));
+        std::streamsize got = in.gcount();
+        for (std::streamsize i = 0; i < got; i++) {
+            hash ^= static_cast<unsigned char>(buf[static_cast<size_t>(i)]);
+            hash *= 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+// HashFile, remembered per path until the file's size or write time change,
+// so looking up several files for one model reads it only once.
+static uint64_t ModelHash(const fs::path& model) {
+    struct Known { uintmax_t size; fs::file_time_type time; uint64_t hash; };
+    static std::mutex mtx;
+    static std::map<fs::path, Known> known;
+
+    std::error_code ec;
+    uintmax_t size = fs::file_size(model, ec);
+    if (ec) return 0;
+    fs::file_time_type time = fs::last_write_time(model, ec);
+    if (ec) return 0;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        auto it = known.find(model);
+        if (it != known.end() && it->second.size == size && it->second.time == time)
+            return it->second.hash;
+    }
+    uint64_t hash = ModelCache::HashFile(model);
+    std::lock_guard<std::mutex> lock(mtx);
+    known[model] = { size, time, hash };
+    return hash;
+}
+
+fs::path ModelCache::EntryPath(const fs::path& model,
+                               const std::string& ort_version,
+                               const char* ep_tag,
+                               const char* extension) {
+    if (!CacheEnabled()) return fs::path();
+    fs::path dir = CacheDirectory();
+    if (dir.empty()) return fs::path();
+
+    uint64_t hash = ModelHash(model);
+    if (hash == 0) return fs::path();
+
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    if (ec) return fs::path();
+
+    char hash_hex[17];
+    std::snprintf(hash_hex, sizeof(hash_hex), "%016llx", static_cast<unsigned long long>(hash));
+    std::string name = model.stem().u8string() + "-" + hash_hex + "-" + ort_version +
+                       "-" + ep_tag + extension;
+    return dir / fs::u8path(name);
+}
+
+// Create file, failing if it already exists.
+static bool CreateExclusive(const fs::path& file) {
+#ifdef _WIN32
+    std::FILE* f = _wfopen(file.c_str(), L"wbx");
+#else
+    std::FILE* f = std::fopen(file.c_str(), "wbx");
+#endif
+    if (!f) return false;
+    std::fclose(f);
+    return true;
+}
+
+fs::path ModelCache::TempPath(const fs::path& entry) {
+    // Threads in one process and processes sharing the cache folder (render
+    // nodes) may write the same entry at once, so each writer gets its own
+    // file: process id, thread and a counter, created exclusively.
+    static std::atomic<unsigned> counter{0};
+#ifdef _WIN32
+    const unsigned long pid = static_cast<unsigned long>(_getpid());
+#else
+    const unsigned long pid = static_cast<unsigned long>(getpid());
+#endif
+    const size_t thread = std::hash<std::thread::id>()(std::this_thread::get_id());
+    for (int attempt = 0; attempt < 8; attempt++) {
+        char suffix[64];
+        std::snprintf(suffix, sizeof(suffix), ".%lu-%zx-%u.tmp", pid, thread, counter++);
+        fs::path temp = entry;
+        temp += suffix;
+        if (CreateExclusive(temp)) return temp;
+    }
+    return fs::path();
+}
+
+// True if file is an entry for the same model stem and EP as entry, i.e.
+// "<stem>-<hash>-<version>-<ep>.ort" with only the hash or version differing.
+static bool IsSiblingEntry(const std::string& file, const std::string& stem, const std::string& ep) {
+    std::string prefix = stem + "-";
+    std::string suffix = "-" + ep + kEntryExtension;
+    if (file.size() <= prefix.size() + suffix.size()) return false;
+    if (file.compare(0, prefix.size(), prefix) != 0) return false;
+    if (file.compare(file.size() - suffix.size(), suffix.size(), suffix) != 0) return false;
+    std::string middle = file.substr(prefix.size(), file.size() - prefix.size() - suffix.size());
+    return std::count(middle.begin(), middle.end(), '-') == 1;
+}
+
+bool ModelCache::Commit(const fs::path& temp, const fs::path& entry, const char* ep_tag) {
+    std::error_code ec;
+    fs::rename(temp, entry, ec);
+    if (ec) {
+        fs::remove(temp, ec);
+        return false;
+    }
+
+    // The stem is everything before the 16-digit hash and the version/EP tail.
+    std::string name = entry.filename().u8string();
+    std::string tail = std::string("-") + ep_tag + kEntryExtension;
+    size_t version_dash = name.rfind('-', name.size() - tail.size() - 1);
+    if (version_dash == std::string::npos || version_dash < 17) return true;
+    std::string stem = name.substr(0, version_dash - 17);
+
+    for (const auto& file : fs::directory_iterator(entry.parent_path(), ec)) {
+        std::string other = file.path().filename().u8string();
+        if (other != name && IsSiblingEntry(other, stem, ep_tag)) {
+            std::error_code rm_ec;
+            fs::remove(file.path(), rm_ec);
+        }
+    }
+    return true;
+}
+
+void ModelCache::Invalidate(const fs::path& entry) {
+    std::error_code ec;
+    fs::remove(entry, ec);
+}
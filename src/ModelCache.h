@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+// On-disk cache of ORT-format models that have already been through graph
+// optimization. Entries are named
+//   <model stem>-<content hash>-<ORT version>-<EP tag>.ort
+// so editing the model, upgrading ONNX Runtime or switching EP all miss and
+// re-optimize. Writing an entry removes older entries for the same model
+// stem, so the cache holds at most one file per (model, EP).
+//
+// Location: AE_YOLO_MODEL_CACHE_DIR if set, otherwise the per-user cache
+// directory (%LOCALAPPDATA%\AE_YOLO\ModelCache, ~/Library/Caches/AE_YOLO,
+// $XDG_CACHE_HOME/AE_YOLO). AE_YOLO_MODEL_CACHE=0 disables the cache.
+namespace ModelCache {
+
+    // 64-bit FNV-1a over the file contents. Returns 0 if it cannot be read.
+    uint64_t HashFile(const std::filesystem::path& file);
+
+    // Cache file path for this model, ORT version and EP tag (e.g. "cpu",
+    // "dml"), creating the cache directory if needed. Returns an empty path
+    // when caching is disabled or the model cannot be hashed. Other per-model
+    // files (TuneProfile) share the naming with their own extension. The model
+    // hash is remembered while the file's size and time stay the same.
+    std::filesystem::path EntryPath(const std::filesystem::path& model,
+                                    const std::string& ort_version,
+                                    const char* ep_tag,
+                                    const char* extension = ".ort");
+
+    // Temporary path to write an entry to before Commit renames it into place,
+    // so a crash mid-write never leaves a truncated entry behind. The file is
+    // created empty, exclusively and with a name unique to this writer
+    // (process, thread, counter), so concurrent writers of one entry never
+    // share it. Empty if it cannot be created.
+    std::filesystem::path TempPath(const std::filesystem::path& entry);
+
+    // Move a fully written temp file to entry and delete stale entries for the
+    // same model stem and EP. Returns false (and removes the temp file) on error.
+    bool Commit(const std::filesystem::path& temp, const std::filesystem::path& entry,
+                const char* ep_tag);
+
+    // Delete an entry that failed to load.
+    void Invalidate(const std::filesystem::path& entry);
+}
@@ -0,0 +1,194 @@
+#include "StubBackend.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+static const int   kNumKeypoints = 17;
+static const float kStubConfidence = 0.9f;
+static const int   kAnchorStrides[] = { 8, 16, 32 };
+
+// COCO-17 order (nose, eyes, ears, shoulders, elbows, wrists, hips, knees,
+// ankles; left before right), as fractions of the box width / height from its
+// centre. The person faces the camera, so left keypoints are on the right.
+const float StubBackend::kSkeleton[17][2] = {
+    {  0.00f, -0.42f },
+    {  0.06f, -0.45f }, { -0.06f, -0.45f },
+    {  0.12f, -0.43f }, { -0.12f, -0.43f },
+    {  0.30f, -0.28f }, { -0.30f, -0.28f },
+    {  0.40f, -0.10f }, { -0.40f, -0.10f },
+    {  0.45f,  0.05f }, { -0.45f,  0.05f },
+    {  0.18f,  0.05f }, { -0.18f,  0.05f },
+    {  0.20f,  0.27f }, { -0.20f,  0.27f },
+    {  0.20f,  0.48f }, { -0.20f,  0.48f },
+};
+
+StubBackend::StubBackend(const StubBackendOptions& options) : options_(options) {
+    options_.input_size     = std::max(32, options_.input_size);
+    options_.max_detections = std::max(1, options_.max_detections);
+}
+
+void StubBackend::EnsureSession(const char* model_path_utf8, bool, int input_size) {
+    model_path_ = model_path_utf8 ? model_path_utf8 : "";
+    input_size_ = options_.dynamic_input && input_size > 0 ? input_size : options_.input_size;
+    input_w_ = input_h_ = input_size_;
+    bound_input_.assign(static_cast<size_t>(3) * input_w_ * input_h_, 0.0f);
+    ready_ = true;
+}
+
+bool StubBackend::SetInputShape(int width, int height) {
+    if (!ready_ || width <= 0 || height <= 0) return false;
+    if (!options_.dynamic_input) return width == input_size_ && height == input_size_;
+    input_w_ = width;
+    input_h_ = height;
+    bound_input_.resize(static_cast<size_t>(3) * width * height);
+    return true;
+}
+
+size_t StubBackend::OutputSize(int width, int height) const {
+    if (options_.format == StubOutputFormat::PostNms)
+        return static_cast<size_t>(options_.max_detections) * (6 + kNumKeypoints * 3);
+    size_t anchors = 0;
+    for (int stride : kAnchorStrides)
+        anchors += static_cast<size_t>(width / stride) * static_cast<size_t>(height / stride);
+    return anchors * (5 + kNumKeypoints * 3);
+}
+
+std::vector<int64_t> StubBackend::OutputShape(int batch, int width, int height) const {
+    const int64_t features = options_.format == StubOutputFormat::PostNms ? 6 + kNumKeypoints * 3
+                                                                          : 5 + kNumKeypoints * 3;
+    const int64_t rows = static_cast<int64_t>(OutputSize(width, height)) / features;
+    if (options_.format == StubOutputFormat::PostNms) return { batch, rows, features };
+    return { batch, features, rows };
+}
+
+void StubBackend::SubjectCentre(const float* input_chw, int width, int height,
+                                float& cx, float& cy) {
+    const size_t plane = static_cast<size_t>(width) * height;
+    const float gray = 114.0f / 255.0f;
+    double sum = 0.0, sum_x = 0.0, sum_y = 0.0;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            const size_t i = static_cast<size_t>(y) * width + x;
+            double w = std::fabs(input_chw[i] - gray) + std::fabs(input_chw[plane + i] - gray) +
+                       std::fabs(input_chw[2 * plane + i] - gray);
+            sum += w;
+            sum_x += w * x;
+            sum_y += w * y;
+        }
+    }
+    if (sum < 1e-3) {
+        cx = width * 0.5f;
+        cy = height * 0.5f;
+        return;
+    }
+    cx = static_cast<float>(sum_x / sum) + 0.5f;
+    cy = static_cast<float>(sum_y / sum) + 0.5f;
+}
+
+float StubBackend::SubjectHeight(int, int height) {
+    return height * 0.6f;
+}
+
+void StubBackend::Synthesize(const float* input_chw, int width, int height, float* out) const {
+    std::fill(out, out + OutputSize(width, height), 0.0f);
+    float cx, cy;
+    SubjectCentre(input_chw, width, height, cx, cy);
+    const float bh = SubjectHeight(width, height);
+    const float bw = bh * 0.5f;
+
+    if (options_.format == StubOutputFormat::PostNms) {
+        // Row 0: [x1, y1, x2, y2, conf, class, kp0_x, kp0_y, kp0_conf, ...]
+        out[0] = cx - bw / 2;
+        out[1] = cy - bh / 2;
+        out[2] = cx + bw / 2;
+        out[3] = cy + bh / 2;
+        out[4] = kStubConfidence;
+        out[5] = 0.0f;
+        for (int k = 0; k < kNumKeypoints; k++) {
+            out[6 + k * 3]     = cx + kSkeleton[k][0] * bw;
+            out[6 + k * 3 + 1] = cy + kSkeleton[k][1] * bh;
+            out[6 + k * 3 + 2] = kStubConfidence;
+        }
+        return;
+    }
+
+    // Feature-major [56, anchors]: the person goes in the stride-8 anchor
+    // whose cell holds the box centre; every other anchor has confidence 0.
+    const size_t anchors = OutputSize(width, height) / (5 + kNumKeypoints * 3);
+    const int grid_w = width / kAnchorStrides[0];
+    const int grid_h = height / kAnchorStrides[0];
+    const int gx = std::min(std::max(static_cast<int>(cx) / kAnchorStrides[0], 0), grid_w - 1);
+    const int gy = std::min(std::max(static_cast<int>(cy) / kAnchorStrides[0], 0), grid_h - 1);
+    const size_t a = static_cast<size_t>(gy) * grid_w + gx;
+    out[0 * anchors + a] = cx;
+    out[1 * anchors + a] = cy;
+    out[2 * anchors + a] = bw;
+    out[3 * anchors + a] = bh;
+    out[4 * anchors + a] = kStubConfidence;
+    for (int k = 0; k < kNumKeypoints; k++) {
+        const size_t base = 5 + k * 3;
+        out[base * anchors + a]       = cx + kSkeleton[k][0] * bw;
+        out[(base + 1) * anchors + a] = cy + kSkeleton[k][1] * bh;
+        out[(base + 2) * anchors + a] = kStubConfidence;
+    }
+}
+
+bool StubBackend::Simulate(int n) {
+    using clock = std::chrono::steady_clock;
+    const double ms = options_.run_latency_ms + options_.image_latency_ms * n;
+    const auto end = clock::now() + std::chrono::microseconds(static_cast<int64_t>(ms * 1000.0));
+    // Sleep in short slices so RequestCancel lands within a few ms, as a
+    // terminated ORT run does.
+    while (!cancel_) {
+        auto now = clock::now();
+        if (now >= end) return true;
+        std::this_thread::sleep_for(std::min<clock::duration>(end - now, std::chrono::milliseconds(5)));
+    }
+    return false;
+}
+
+bool StubBackend::RunInference(TensorView& output) {
+    if (!ready_ || !Simulate(1)) return false;
+    bound_output_.resize(OutputSize(input_w_, input_h_));
+    Synthesize(bound_input_.data(), input_w_, input_h_, bound_output_.data());
+    bound_output_shape_ = OutputShape(1, input_w_, input_h_);
+    output = TensorView::Of(bound_output_, bound_output_shape_);
+    return true;
+}
+
+bool StubBackend::RunInference(const float* input_chw, int input_size,
+                               std::vector<float>& raw_output,
+                               std::vector<int64_t>& out_shape) {
+    if (!ready_) return false;
+    int width = input_w_, height = input_h_;
+    if (input_size > 0) {
+        if (!options_.dynamic_input && input_size != input_size_) return false;
+        width = height = input_size;
+    }
+    if (!Simulate(1)) return false;
+    raw_output.resize(OutputSize(width, height));
+    Synthesize(input_chw, width, height, raw_output.data());
+    out_shape = OutputShape(1, width, height);
+    return true;
+}
+
+bool StubBackend::RunInferenceBatch(const float* const* inputs, int n,
+                                    std::vector<float>& raw_output,
+                                    std::vector<int64_t>& out_shape) {
+    if (!ready_ || n <= 0) return false;
+    // A fixed batch axis means one run per image, as YoloEngine loops.
+    if (options_.dynamic_batch) {
+        if (!Simulate(n)) return false;
+    } else {
+        for (int i = 0; i < n; i++)
+            if (!Simulate(1)) return false;
+    }
+    const size_t image = OutputSize(input_w_, input_h_);
+    raw_output.resize(image * n);
+    for (int i = 0; i < n; i++)
+        Synthesize(inputs[i], input_w_, input_h_, raw_output.data() + image * i);
+    out_shape = OutputShape(n, input_w_, input_h_);
+    return true;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "InferenceBackend.h"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+// Output layout the stub produces, matching the two formats YoloPostprocess
+// detects.
+enum class StubOutputFormat {
+    RawAnchors,   // YOLOv8/11 [N, 56, anchors], e.g. [1, 56, 8400] at 640x640
+    PostNms,      // YOLO26 end-to-end [N, max_detections, 57]
+};
+
+struct StubBackendOptions {
+    StubOutputFormat format        = StubOutputFormat::RawAnchors;
+    int    input_size              = 640;    // square input, and the long side of dynamic ones
+    bool   dynamic_input           = true;   // accepts SetInputShape rectangles
+    bool   dynamic_batch           = true;
+    int    max_detections          = 300;    // PostNms rows
+    // Simulated inference time: run_latency_ms per Run call plus
+    // image_latency_ms per image in it, so batching pays off as on a real
+    // model. Cancel interrupts the wait.
+    double run_latency_ms          = 0.0;
+    double image_latency_ms        = 0.0;
+};
+
+// Deterministic InferenceBackend with no model and no ONNX Runtime. Each image
+// gets one person: a fixed COCO-17 skeleton (confidence 0.9) whose box is
+// centred on the image's "content", the centroid of how far each pixel is
+// from the letterbox gray (114). A frame with a bright or dark subject on a
+// flat background therefore yields a detection that follows the subject, a
+// flat frame one in the middle, and the same input always the same output.
+// The model path passed to EnsureSession is recorded but never opened.
+class StubBackend : public InferenceBackend {
+public:
+    explicit StubBackend(const StubBackendOptions& options = StubBackendOptions());
+
+    const char* Name() const override { return "stub"; }
+
+    void EnsureSession(const char* model_path_utf8, bool use_gpu, int input_size = 0) override;
+    bool IsReady() override { return ready_; }
+    std::string ActiveModelPath() override { return model_path_; }
+
+    int  GetInputSize() override { return ready_ ? input_size_ : 0; }
+    bool HasDynamicInputSize() override { return ready_ && options_.dynamic_input; }
+    bool SetInputShape(int width, int height) override;
+    int  GetInputWidth() override { return ready_ ? input_w_ : 0; }
+    int  GetInputHeight() override { return ready_ ? input_h_ : 0; }
+    bool HasDynamicBatch() override { return ready_ && options_.dynamic_batch; }
+    int  ParallelSessionCount() override { return ready_ ? 1 : 0; }
+    int  PreferredBatchSize() override { return options_.dynamic_batch ? 4 : 1; }
+
+    std::vector<float>& InputBuffer() override { return bound_input_; }
+    bool RunInference(TensorView& output) override;
+    bool RunInference(const float* input_chw, int input_size,
+                      std::vector<float>& raw_output,
+                      std::vector<int64_t>& out_shape) override;
+    bool RunInferenceBatch(const float* const* inputs, int n,
+                           std::vector<float>& raw_output,
+                           std::vector<int64_t>& out_shape) override;
+
+    void RequestCancel() override { cancel_ = true; }
+    void ResetCancel() override { cancel_ = false; }
+
+    // Where the stub puts the person for an input, in model input pixels:
+    // box centre and height. Tests compare postprocessed keypoints with it.
+    static void SubjectCentre(const float* input_chw, int width, int height,
+                              float& cx, float& cy);
+    static float SubjectHeight(int width, int height);
+
+    // Skeleton template: keypoint k sits at centre + (x, y) * box size.
+    static const float kSkeleton[17][2];
+
+    // Output elements for one image at width x height.
+    size_t OutputSize(int width, int height) const;
+
+private:
+    // Write image output (OutputSize floats) for one CHW input.
+    void Synthesize(const float* input_chw, int width, int height, float* out) const;
+    std::vector<int64_t> OutputShape(int batch, int width, int height) const;
+    // Sleep for the simulated latency of a run over n images. False if
+    // cancelled before or during the wait.
+    bool Simulate(int n);
+
+    StubBackendOptions   options_;
+    bool                 ready_      = false;
+    std::string          model_path_;
+    int                  input_size_ = 640;
+    int                  input_w_    = 640;
+    int                  input_h_    = 640;
+    std::vector<float>   bound_input_;
+    std::vector<float>   bound_output_;
+    std::vector<int64_t> bound_output_shape_;
+    std::atomic<bool>    cancel_{false};
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Float16.h"
+
+enum class TensorElement { Float32, Float16 };
+
+// Non-owning view of a float or half tensor: data pointer, element type and
+// shape. Used to hand model output from YoloEngine to YoloPostprocess without
+// copying or widening it; the viewed memory belongs to whoever produced it
+// (see each producer for how long it stays valid).
+struct TensorView {
+    const void*    data  = nullptr;
+    TensorElement  type  = TensorElement::Float32;
+    const int64_t* shape = nullptr;
+    int            rank  = 0;
+
+    // Typed element pointer; T must match `type`.
+    template <typename T>
+    const T* As() const { return static_cast<const T*>(data); }
+
+    int64_t Dim(int i) const { return shape[i]; }
+
+    size_t Count() const {
+        if (!data || rank <= 0) return 0;
+        size_t n = 1;
+        for (int i = 0; i < rank; i++) n *= static_cast<size_t>(shape[i]);
+        return n;
+    }
+
+    // View over a vector-owned tensor (e.g. RunInferenceBatch output).
+    static TensorView Of(const std::vector<float>& values, const std::vector<int64_t>& dims) {
+        TensorView view;
+        view.data  = values.data();
+        view.shape = dims.data();
+        view.rank  = static_cast<int>(dims.size());
+        return view;
+    }
+
+    static TensorView Of(const std::vector<Float16>& values, const std::vector<int64_t>& dims) {
+        TensorView view;
+        view.data  = values.data();
+        view.type  = TensorElement::Float16;
+        view.shape = dims.data();
+        view.rank  = static_cast<int>(dims.size());
+        return view;
+    }
+};
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Minimal persistent worker pool (header-only).
+// ParallelFor splits [0, count) into contiguous chunks; the calling thread
+// works on chunks too, so calls from several threads at once (or from inside a
+// worker) cannot deadlock.
+
+class ThreadPool {
+public:
+    explicit ThreadPool(int num_workers) {
+        for (int i = 0; i < num_workers; i++)
+            workers_.emplace_back([this] { WorkerLoop(); });
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& t : workers_) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int NumWorkers() const { return static_cast<int>(workers_.size()); }
+
+    // Process-wide pool with one worker per hardware thread (minus the caller).
+    // Intentionally never destroyed: joining threads from a static destructor
+    // while the host unloads the plugin can deadlock on the loader lock.
+    static ThreadPool& Shared() {
+        static ThreadPool* pool = new ThreadPool(std::max(0, HardwareThreads() - 1));
+        return *pool;
+    }
+
+    static int HardwareThreads() {
+        unsigned n = std::thread::hardware_concurrency();
+        return n > 0 ? static_cast<int>(n) : 1;
+    }
+
+    // Run fn(begin, end) over [0, count) in up to num_chunks pieces and block
+    // until all of them have finished.
+    void ParallelFor(int count, int num_chunks, const std::function<void(int, int)>& fn) {
+        if (count <= 0) return;
+        num_chunks = std::max(1, std::min(num_chunks, count));
+        if (num_chunks == 1 || workers_.empty()) {
+            fn(0, count);
+            return;
+        }
+
+        // Shared so a worker that dequeues its task after every chunk is taken
+        // only touches live state (and then returns without calling fn).
+        struct Job {
+            std::atomic<int> next{0};
+            std::atomic<int> remaining{0};
+            int count = 0, num_chunks = 0;
+            const std::function<void(int, int)>* fn = nullptr;
+            std::mutex done_mutex;
+            std::condition_variable done_cv;
+        };
+        auto job = std::make_shared<Job>();
+        job->remaining = num_chunks;
+        job->count = count;
+        job->num_chunks = num_chunks;
+        job->fn = &fn;
+
+        auto drain = [job] {
+            int c;
+            while ((c = job->next.fetch_add(1)) < job->num_chunks) {
+                int begin = static_cast<int>(static_cast<long long>(job->count) * c / job->num_chunks);
+                int end   = static_cast<int>(static_cast<long long>(job->count) * (c + 1) / job->num_chunks);
+                (*job->fn)(begin, end);
+                if (job->remaining.fetch_sub(1) == 1) {
+                    std::lock_guard<std::mutex> lock(job->done_mutex);
+                    job->done_cv.notify_all();
+                }
+            }
+        };
+
+        int helpers = std::min(num_chunks - 1, NumWorkers());
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (int i = 0; i < helpers; i++) tasks_.push_back(drain);
+        }
+        if (helpers == 1) cv_.notify_one(); else cv_.notify_all();
+
+        drain();
+
+        std::unique_lock<std::mutex> lock(job->done_mutex);
+        job->done_cv.wait(lock, [&] { return job->remaining.load() == 0; });
+    }
+
+private:
+    void WorkerLoop() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+                if (stop_ && tasks_.empty()) return;
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread>          workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex                        mutex_;
+    std::condition_variable           cv_;
+    bool                              stop_ = false;
+};
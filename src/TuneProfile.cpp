@@ -0,0 +1,93 @@
+#include "TuneProfile.h"
+#include "ModelCache.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+static const char* const kProfileExtension = ".tune";
+
+std::string TuneProfile::MachineTag() {
+    char host[256] = {};
+#ifdef _WIN32
+    DWORD size = sizeof(host);
+    if (!GetComputerNameA(host, &size)) host[0] = 0;
+#else
+    if (gethostname(host, sizeof(host) - 1) != 0) host[0] = 0;
+#endif
+    std::string tag;
+    for (const char* c = host; *c && tag.size() < 32; c++) {
+        unsigned char ch = static_cast<unsigned char>(*c);
+        tag += std::isalnum(ch) ? static_cast<char>(ch) : '_';
+    }
+    if (tag.empty()) tag = "host";
+    return tag + "_" + std::to_string(std::thread::hardware_concurrency()) + "t";
+}
+
+fs::path TuneProfile::PathFor(const fs::path& model, const std::string& ort_version,
+                              const char* ep_request) {
+    std::string tag = std::string(ep_request) + "-" + MachineTag();
+    return ModelCache::EntryPath(model, ort_version, tag.c_str(), kProfileExtension);
+}
+
+bool TuneProfile::Load(const fs::path& file, Profile& profile) {
+    std::ifstream in(file);
+    if (!in) return false;
+
+    Profile p;
+    bool has_threads = false;
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t eq = line.find('=');
+        if (line.empty() || line[0] == '#' || eq == std::string::npos) continue;
+        std::string key = line.substr(0, eq);
+        const char* value = line.c_str() + eq + 1;
+        if      (key == "use_gpu")  p.use_gpu  = std::atoi(value) != 0;
+        else if (key == "threads")  { p.threads = std::atoi(value); has_threads = true; }
+        else if (key == "sessions") p.sessions = std::atoi(value);
+        else if (key == "batch")    p.batch    = std::atoi(value);
+        else if (key == "parallel") p.parallel = std::atoi(value) != 0;
+        else if (key == "arena")    p.arena    = std::atoi(value) != 0;
+        else if (key == "fps")      p.fps      = std::atof(value);
+    }
+    if (!has_threads || p.threads < 1 || p.sessions < 1 || p.batch < 1) return false;
+    profile = p;
+    return true;
+}
+
+bool TuneProfile::Save(const fs::path& file, const Profile& profile) {
+    fs::path temp = ModelCache::TempPath(file);
+    if (temp.empty()) return false;
+    {
+        std::ofstream out(temp, std::ios::trunc);
+        if (!out) return false;
+        out << "# AE_YOLO auto-tuned configuration; delete this file to tune again\n"
+            << "use_gpu="  << (profile.use_gpu ? 1 : 0) << "\n"
+            << "threads="  << profile.threads << "\n"
+            << "sessions=" << profile.sessions << "\n"
+            << "batch="    << profile.batch << "\n"
+            << "parallel=" << (profile.parallel ? 1 : 0) << "\n"
+            << "arena="    << (profile.arena ? 1 : 0) << "\n"
+            << "fps="      << profile.fps << "\n";
+        if (!out) {
+            out.close();
+            ModelCache::Invalidate(temp);
+            return false;
+        }
+    }
+    std::error_code ec;
+    fs::rename(temp, file, ec);
+    if (ec) ModelCache::Invalidate(temp);
+    return !ec;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+// Auto-tuned session configuration for one model on one machine, stored next
+// to the model cache entries as
+//   <model stem>-<content hash>-<ORT version>-<gpu|cpu>-<machine>.tune
+// so a changed model, an ONNX Runtime upgrade or another machine sharing
+// the cache folder each tune again. "gpu" profiles were tuned with a GPU EP
+// available and may still pick the CPU. The file is plain "key=value" lines.
+namespace TuneProfile {
+
+    struct Profile {
+        bool   use_gpu  = false;   // GPU EP beat the best CPU configuration
+        // Best CPU configuration (also used when the GPU EP fails to attach)
+        int    threads  = 0;       // intra-op threads over all sessions
+        int    sessions = 1;       // parallel sessions of the model
+        int    batch    = 1;       // frames per inference call
+        bool   parallel = false;   // ORT_PARALLEL execution mode
+        bool   arena    = true;    // CPU memory arena
+        double fps      = 0.0;     // measured throughput of the winner
+    };
+
+    // Host name and hardware thread count, reduced to [A-Za-z0-9_].
+    std::string MachineTag();
+
+    // Profile path for this model, ORT version and requested EP ("gpu" or
+    // "cpu"), or empty when the model cache is disabled.
+    std::filesystem::path PathFor(const std::filesystem::path& model,
+                                  const std::string& ort_version,
+                                  const char* ep_request);
+
+    // Read a profile. Returns false if it is missing or unusable.
+    bool Load(const std::filesystem::path& file, Profile& profile);
+
+    // Write a profile (via a temp file renamed into place).
+    bool Save(const std::filesystem::path& file, const Profile& profile);
+}
@@ -2,18 +2,38 @@
 
 #define ORT_API_MANUAL_INIT
 #include "onnxruntime_cxx_api.h"
+#include "onnxruntime_session_options_config_keys.h"
+#include "onnxruntime_run_options_config_keys.h"
 
+#include "EnvUtil.h"
+#include "MappedFile.h"
+#include "ModelCache.h"
+#include "StubBackend.h"
+#include "ThreadPool.h"
+#include "TuneProfile.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
 #include <memory>
 #include <mutex>
+#include <thread>
 #include <string>
 #include <vector>
+#include <list>
+#include <utility>
 #include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
 
 #ifdef _WIN32
 #define NOMINMAX
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 #include <shlwapi.h>
+#include <intrin.h>
 #pragma comment(lib, "shlwapi.lib")
 #endif
 
@@ -23,6 +43,8 @@
 #include <libgen.h>
 #endif
 
+namespace fs = std::filesystem;
+
 // Forward-declare execution providers
 #ifdef _WIN32
 extern "C" OrtStatusPtr ORT_API_CALL OrtSessionOptionsAppendExecutionProvider_DML(
@@ -34,23 +56,211 @@ extern "C" OrtStatusPtr OrtSessionOptionsAppendExecutionProvider_CoreML(
     OrtSessionOptions* options, uint32_t coreml_flags);
 #endif
 
+// ============================================================================
+// Session cache
+// ============================================================================
+struct PrepackedWeightsDeleter {
+    void operator()(OrtPrepackedWeightsContainer* c) const {
+        Ort::GetApi().ReleasePrepackedWeightsContainer(c);
+    }
+};
+using PrepackedWeightsPtr = std::unique_ptr<OrtPrepackedWeightsContainer, PrepackedWeightsDeleter>;
+
+// Scratch for handing float CHW input to a model that takes another type.
+struct ConvertedInput {
+    std::vector<Float16>       half;
+    std::vector<unsigned char> rgb8;
+};
+
+// How a model runs on the CPU EP: the defaults from the environment, or the
+// winner of the auto-tuner (TuneProfile).
+struct CpuConfig {
+    int  threads  = 0;       // intra-op threads over all sessions
+    int  sessions = 1;       // the session plus replicas
+    int  batch    = 0;       // frames per RunInferenceBatch call; 0 = heuristic
+    bool parallel = false;   // ORT_PARALLEL execution mode
+    bool arena    = true;    // CPU memory arena
+};
+
+// One loaded model: the ORT session plus everything cached per session to
+// avoid per-call ORT allocations. Members are destroyed in reverse order, so
+// the binding and output values go before the session they reference.
+struct CachedSession {
+    // Cache key: model path, requested EP and input size
+    std::string model_path;
+    bool        use_gpu    = true;
+    bool        gpu_ok     = false;   // a GPU EP was actually attached
+    size_t      est_bytes  = 0;       // estimated resident size, for the budget
+    CpuConfig   cpu;                  // CPU sessions only
+
+    std::unique_ptr<Ort::SessionOptions> options;
+    std::unique_ptr<MappedFile>          mapped_model;   // ORT bytes the sessions use in place
+    std::unique_ptr<Ort::Session>        session;
+
+    // CPU only, with cpu.sessions = K > 1: K-1 more sessions on the
+    // same model (their prepacked weights come from g_prepacked like every CPU
+    // session's). Each of the K has its own pool of intra-op threads / K, and
+    // RunInferenceBatch runs frames on all at once.
+    std::vector<std::unique_ptr<Ort::Session>> replicas;
+
+    int  input_size    = 640;         // long side; the model's own size if fixed
+    bool dynamic_input = false;       // H/W are symbolic dims
+    bool dynamic_batch = false;       // N is a symbolic dim
+
+    // Current input shape. Square (input_size) unless SetInputShape picked a
+    // narrower rectangle for a dynamic-H/W model. Each shape is warmed up once.
+    int  input_w       = 640;
+    int  input_h       = 640;
+    std::vector<std::pair<int, int>> warmed_shapes;
+
+    // FP16 models (exported with half=True) take and/or return float16
+    // tensors. The zero-copy path then letterboxes into bound_input_half and
+    // hands the half output to YoloPostprocess as is, so ORT adds no Cast
+    // nodes and each frame moves half the bytes.
+    bool half_input    = false;
+    bool half_output   = false;
+
+    // uint8 NHWC models (tools/fold_uint8_input.py) do the /255 and the CHW
+    // transpose in the graph; the zero-copy path feeds them RGB bytes in
+    // bound_input_rgb8, a quarter of the float input's size.
+    bool rgb8_input    = false;
+
+    std::string        input_name;
+    std::string        output_name;
+    std::vector<float> input_buffer;  // reused each inference call
+    ConvertedInput     input_converted;   // input_buffer for FP16 / uint8 models
+
+    // Zero-copy single-image path (InputBuffer + RunInference(TensorView&)). On
+    // the CPU EP the input and output buffers are bound once per session with
+    // IoBinding, so steady-state runs neither allocate nor copy. GPU EPs run on
+    // the same input buffer without binding.
+    std::vector<float>               bound_input;        // float-input models
+    std::vector<Float16>             bound_input_half;   // FP16-input models
+    std::vector<unsigned char>       bound_input_rgb8;   // uint8 NHWC models
+    std::vector<float>               bound_output;
+    std::vector<Float16>             bound_output_half;
+    std::vector<int64_t>             bound_output_shape;
+    std::unique_ptr<Ort::IoBinding>  binding;
+    std::vector<Ort::Value>          last_outputs;   // keeps unbound outputs alive for views
+    std::vector<int64_t>             last_output_shape;
+};
+
+static const int    kDefaultInputSize     = 640;
+static const size_t kDefaultCacheBudgetMB = 2048;
+
 // ============================================================================
 // Globals
 // ============================================================================
 static std::unique_ptr<Ort::Env>            g_env;
-static std::unique_ptr<Ort::Session>        g_session;
-static std::unique_ptr<Ort::SessionOptions> g_options;
-static std::string                          g_current_model_path;
-static bool                                 g_current_use_gpu = true;
-static bool                                 g_initialized     = false;
-static bool                                 g_session_ready   = false;
-static int                                  g_input_size      = 640;
+static bool                                 g_initialized  = false;
 static std::once_flag                       g_init_flag;
 
-// Cached per-session inference state (avoids per-call ORT allocations)
-static std::string                          g_input_name;
-static std::string                          g_output_name;
-static std::vector<float>                   g_input_buffer;   // reused each inference call
+// Loaded sessions, most recently used first. g_active is the session the
+// inference calls run on; EnsureSession swaps it in one store once the new
+// session is fully loaded, so nothing ever runs on a half-built session.
+static std::list<std::unique_ptr<CachedSession>> g_sessions;
+static std::atomic<CachedSession*>          g_active{nullptr};
+static size_t                               g_cache_budget = kDefaultCacheBudgetMB << 20;
+
+// One process-wide ORT thread pool shared by every session. Sizes come from
+// the hardware unless AE_YOLO_INTRA_OP_THREADS / AE_YOLO_INTER_OP_THREADS
+// override them. If the env could not be created with global pools, sessions
+// fall back to per-session pools of the same intra-op size.
+static bool                                 g_global_pools   = false;
+static int                                  g_intra_threads  = 1;
+static int                                  g_inter_threads  = 1;
+static int                                  g_cpu_sessions   = 1;   // K parallel CPU sessions per model
+
+// Cooperative CPU mode (AE_YOLO_COOPERATIVE_CPU=1): ORT's pool threads block
+// as soon as they run out of work instead of spinning first. During Analyze,
+// AE renders the next frame while our threads would otherwise still be
+// spinning on every core after the previous inference.
+static bool                                 g_cooperative    = false;
+
+// Memory-mapped model loading (AE_YOLO_MMAP_MODEL=1): sessions are created
+// from a read-only map of the model cache entry and use its bytes for the
+// graph and initializers in place, so sessions and AE processes on one
+// machine share the weights through the page cache instead of each reading
+// and holding a heap copy.
+static bool                                 g_mmap_models    = false;
+
+// GPU model cache entries (AE_YOLO_MODEL_CACHE_GPU, default 0). An ORT-format
+// model gets no graph transformers at load, so a GPU entry saved at BASIC
+// misses the fusions the EP's session would apply to the .onnx. Only turn it
+// on where test/bench_model_cache.py shows the entry running as fast.
+static bool                                 g_cache_gpu      = false;
+
+// Auto-tuning (AE_YOLO_AUTOTUNE, default 0, opt-in): a load that finds no
+// profile for its model on this machine uses the defaults and queues a tune.
+// Nothing benchmarks unattended: the next Analyze runs the queued tune
+// (RunPendingTune) before its frames, with progress and Cancel, and later
+// loads apply the saved winner. Off when AE_YOLO_INTRA_OP_THREADS or
+// AE_YOLO_CPU_SESSIONS pin the configuration by hand, or when the model
+// cache is disabled.
+static bool                                 g_autotune       = false;
+
+// Run options shared by every inference call. RequestCancel sets terminate on
+// them, so in-flight Run calls (every session and replica) stop at the next
+// kernel boundary instead of finishing the frame; ResetCancel clears it.
+// Warm-up runs use their own options and are never cancelled. While
+// SetArenaShrinkage(true) is in effect, runs use g_shrink_run_options
+// instead, which also hand the CPU arena's free regions back to the OS.
+static std::unique_ptr<Ort::RunOptions>     g_run_options;
+static std::unique_ptr<Ort::RunOptions>     g_shrink_run_options;
+static std::atomic<bool>                    g_shrink_runs{false};
+static std::atomic<bool>                    g_cancel_requested{false};
+
+// Resources shared by all sessions, created with the first load and released
+// when the last session goes (idle unload or Shutdown); see
+// AcquireSharedResources.
+//
+// Prepacked weights for every CPU session the engine creates. ORT keys them
+// by the packed contents, so two sessions of the same model (K parallel
+// sessions, a dynamic model cached at two input sizes, a reload after
+// eviction) hold one copy, while different models never collide.
+static PrepackedWeightsPtr                  g_prepacked;
+
+// One CPU arena, registered on the env, that every session allocates from
+// (session.use_env_allocators). AE_YOLO_ARENA_EXTEND picks the extend
+// strategy (default 1 = grow by the requested size; 0 = next power of two)
+// and AE_YOLO_ARENA_INITIAL_MB the first chunk (0 = ORT's default).
+static bool                                 g_env_arena      = false;
+static int                                  g_arena_extend   = 1;
+static int                                  g_arena_initial_mb = 0;
+
+// Idle unload (AE_YOLO_IDLE_UNLOAD_MIN, default 30, 0 = never): after that
+// long without a load or a pinned inference sequence (SessionPin), a watcher
+// thread unloads every session and the shared resources, so an AE session
+// left open for days does not hold the model and arena memory.
+static int                                  g_idle_unload_min = 30;
+static int                                  g_pins           = 0;       // live pins (PinSessions / SessionPin)
+static std::chrono::steady_clock::time_point g_last_use;
+static std::thread                          g_idle_thread;
+static std::condition_variable              g_idle_cv;
+static bool                                 g_idle_stop      = false;
+
+// Background loads started by PreloadSession. done becomes ready once the
+// worker has inserted its session (or failed); the thread is joined after.
+struct PreloadTask {
+    std::string              model_path;
+    bool                     use_gpu    = true;
+    int                      input_size = 0;
+    std::shared_future<void> done;
+    std::thread              thread;
+};
+static std::list<PreloadTask>               g_preloads;
+
+// Tunes queued by loads that found no profile, run by RunPendingTune.
+// g_tune_mutex guards the queue and is never held while taking GetMutex().
+struct TuneRequest {
+    fs::path model_file;
+    fs::path profile_file;
+    bool     quantized  = false;
+    bool     try_gpu    = false;
+    int      input_size = 0;
+};
+static std::mutex                           g_tune_mutex;
+static std::list<TuneRequest>               g_tune_queue;
 
 static std::mutex& GetMutex() {
     static std::mutex mtx;
@@ -113,6 +323,79 @@ static bool PreloadDlls() {
 }
 #endif
 
+// ============================================================================
+// Shared resources and idle unload
+// ============================================================================
+// Create the resources sessions share, if the last unload released them.
+// Caller holds the mutex, before starting a load; failures only cost sharing.
+static void AcquireSharedResources() {
+    if (!g_prepacked) {
+        try {
+            OrtPrepackedWeightsContainer* container = nullptr;
+            Ort::ThrowOnError(Ort::GetApi().CreatePrepackedWeightsContainer(&container));
+            g_prepacked.reset(container);
+        } catch (const Ort::Exception& e) {
+            DebugLog(std::string("AcquireSharedResources: no shared prepacked weights: ") + e.what());
+        }
+    }
+    if (!g_env_arena) {
+        try {
+            Ort::MemoryInfo mem_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+            Ort::ArenaCfg arena(0, g_arena_extend,
+                                g_arena_initial_mb > 0 ? g_arena_initial_mb << 20 : -1, -1);
+            g_env->CreateAndRegisterAllocator(mem_info, arena);
+            g_env_arena = true;
+            DebugLog(std::string("AcquireSharedResources: shared CPU arena (") +
+                     (g_arena_extend ? "same as requested" : "next power of two") +
+                     (g_arena_initial_mb > 0 ? ", initial " + std::to_string(g_arena_initial_mb) + " MB)" : ")"));
+        } catch (const Ort::Exception& e) {
+            DebugLog(std::string("AcquireSharedResources: no shared CPU arena: ") + e.what());
+        }
+    }
+}
+
+// Release the shared resources. Caller holds the mutex, with no sessions
+// left and no load running.
+static void ReleaseSharedResources() {
+    g_prepacked.reset();
+    if (g_env_arena) {
+        Ort::MemoryInfo mem_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        if (OrtStatus* status = Ort::GetApi().UnregisterAllocator(*g_env, mem_info))
+            Ort::GetApi().ReleaseStatus(status);
+        g_env_arena = false;
+    }
+}
+
+// True while a background load is still running. Caller holds the mutex.
+static bool PreloadRunning() {
+    for (auto& task : g_preloads) {
+        if (task.done.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return true;
+    }
+    return false;
+}
+
+// Idle-unload watcher thread. Wakes when the idle timeout since the last use
+// expires and unloads everything unless a SessionPin or a preload is live.
+static void IdleWatcher() {
+    const auto timeout = std::chrono::minutes(g_idle_unload_min);
+    std::unique_lock<std::mutex> lock(GetMutex());
+    while (!g_idle_stop) {
+        auto deadline = g_last_use + timeout;
+        if (std::chrono::steady_clock::now() < deadline) {
+            g_idle_cv.wait_until(lock, deadline);
+            continue;
+        }
+        if (!g_sessions.empty() && g_pins == 0 && !PreloadRunning()) {
+            DebugLog("IdleWatcher: unloading " + std::to_string(g_sessions.size()) +
+                     " idle session(s) after " + std::to_string(g_idle_unload_min) + " min");
+            g_active = nullptr;
+            g_sessions.clear();
+            ReleaseSharedResources();
+        }
+        g_idle_cv.wait_for(lock, timeout);
+    }
+}
+
 // ============================================================================
 // One-time initialization
 // ============================================================================
@@ -144,17 +427,60 @@ static void InitializeInternal() {
 
         Ort::Global<void>::api_ = api;
 
-        OrtEnv* raw_env = nullptr;
-        OrtStatus* status = api->CreateEnv(ORT_LOGGING_LEVEL_WARNING, "AE_YOLO", &raw_env);
-        if (status) {
-            const char* msg = api->GetErrorMessage(status);
-            DebugLog(std::string("InitializeInternal: CreateEnv failed: ") + (msg ? msg : "unknown"));
-            api->ReleaseStatus(status);
-            return;
+        // Intra-op threads split each kernel, so they scale with the cores.
+        // Sessions run ORT_SEQUENTIAL, so the inter-op pool needs one thread.
+        int hw_threads = static_cast<int>(std::thread::hardware_concurrency());
+        g_intra_threads = std::max(1, GetEnvInt("AE_YOLO_INTRA_OP_THREADS", std::max(1, hw_threads)));
+        g_inter_threads = std::max(1, GetEnvInt("AE_YOLO_INTER_OP_THREADS", 1));
+        g_cpu_sessions  = std::max(1, std::min(g_intra_threads, GetEnvInt("AE_YOLO_CPU_SESSIONS", 1)));
+        g_cooperative   = GetEnvInt("AE_YOLO_COOPERATIVE_CPU", 0) > 0;
+        g_mmap_models   = GetEnvInt("AE_YOLO_MMAP_MODEL", 0) > 0;
+        g_cache_gpu     = GetEnvInt("AE_YOLO_MODEL_CACHE_GPU", 0) > 0;
+        g_arena_extend  = GetEnvInt("AE_YOLO_ARENA_EXTEND", 1) > 0 ? 1 : 0;
+        g_arena_initial_mb = std::max(0, std::min(1024, GetEnvInt("AE_YOLO_ARENA_INITIAL_MB", 0)));
+        g_idle_unload_min  = std::max(0, GetEnvInt("AE_YOLO_IDLE_UNLOAD_MIN", 30));
+        g_autotune      = GetEnvInt("AE_YOLO_AUTOTUNE", 0) > 0 &&
+                          !IsEnvSet("AE_YOLO_INTRA_OP_THREADS") && !IsEnvSet("AE_YOLO_CPU_SESSIONS");
+
+        try {
+            Ort::ThreadingOptions threading;
+            threading.SetGlobalIntraOpNumThreads(g_intra_threads);
+            threading.SetGlobalInterOpNumThreads(g_inter_threads);
+            threading.SetGlobalSpinControl(g_cooperative ? 0 : 1);
+            g_env = std::make_unique<Ort::Env>(threading, ORT_LOGGING_LEVEL_WARNING, "AE_YOLO");
+            g_global_pools = true;
+            DebugLog("InitializeInternal: global thread pools (intra " + std::to_string(g_intra_threads) +
+                     ", inter " + std::to_string(g_inter_threads) +
+                     (g_cooperative ? ", no spinning)" : ")"));
+        } catch (const Ort::Exception& e) {
+            DebugLog(std::string("InitializeInternal: global thread pools unavailable: ") + e.what());
         }
 
-        g_env = std::make_unique<Ort::Env>(raw_env);
+        if (!g_env) {
+            OrtEnv* raw_env = nullptr;
+            OrtStatus* status = api->CreateEnv(ORT_LOGGING_LEVEL_WARNING, "AE_YOLO", &raw_env);
+            if (status) {
+                const char* msg = api->GetErrorMessage(status);
+                DebugLog(std::string("InitializeInternal: CreateEnv failed: ") + (msg ? msg : "unknown"));
+                api->ReleaseStatus(status);
+                return;
+            }
+            g_env = std::make_unique<Ort::Env>(raw_env);
+        }
+        g_run_options = std::make_unique<Ort::RunOptions>();
+        g_shrink_run_options = std::make_unique<Ort::RunOptions>();
+        g_shrink_run_options->AddConfigEntry(kOrtRunOptionsConfigEnableMemoryArenaShrinkage, "cpu:0");
         g_initialized = true;
+        g_last_use = std::chrono::steady_clock::now();
+        if (g_idle_unload_min > 0) {
+            g_idle_thread = std::thread(IdleWatcher);
+            DebugLog("InitializeInternal: idle sessions unload after " +
+                     std::to_string(g_idle_unload_min) + " min");
+        }
+
+        // Render nodes can trade memory for reload time.
+        g_cache_budget = static_cast<size_t>(std::max(0,
+            GetEnvInt("AE_YOLO_SESSION_CACHE_MB", static_cast<int>(kDefaultCacheBudgetMB)))) << 20;
         DebugLog("InitializeInternal: ONNX Runtime environment created");
 
     } catch (const std::exception& e) {
@@ -164,178 +490,1164 @@ static void InitializeInternal() {
     }
 }
 
+// Per-session pools take the cooperative setting from session config; the
+// global pools already have it from the env.
+static void ApplySpinning(Ort::SessionOptions& options) {
+    if (!g_cooperative) return;
+    options.AddConfigEntry(kOrtSessionOptionsConfigAllowIntraOpSpinning, "0");
+    options.AddConfigEntry(kOrtSessionOptionsConfigAllowInterOpSpinning, "0");
+}
+
+// Share the global pools, or size a per-session pool the same way.
+static void ApplyThreading(Ort::SessionOptions& options) {
+    if (g_global_pools) {
+        options.DisablePerSessionThreads();
+    } else {
+        options.SetIntraOpNumThreads(g_intra_threads);
+        ApplySpinning(options);
+    }
+}
+
+static CpuConfig DefaultCpuConfig() {
+    CpuConfig c;
+    c.threads  = g_intra_threads;
+    c.sessions = g_cpu_sessions;
+    return c;
+}
+
+static CpuConfig CpuConfigFromProfile(const TuneProfile::Profile& p) {
+    CpuConfig c;
+    c.threads  = std::max(1, p.threads);
+    c.sessions = std::max(1, std::min(c.threads, p.sessions));
+    c.batch    = std::max(1, p.batch);
+    c.parallel = p.parallel;
+    c.arena    = p.arena;
+    return c;
+}
+
+static std::string DescribeCpuConfig(const CpuConfig& c) {
+    return std::to_string(c.threads) + " threads, " + std::to_string(c.sessions) + " session(s), batch " +
+           (c.batch > 0 ? std::to_string(c.batch) : std::string("auto")) +
+           (c.parallel ? ", parallel" : "") + (c.arena ? "" : ", no arena");
+}
+
+// CPU session options for c. The default configuration shares the global
+// pools; anything else gets per-session pools: K smaller pools beat one big
+// one for 640x640 convolutions, and ORT_PARALLEL needs inter-op threads the
+// single-thread global inter-op pool does not have.
+static void ApplyCpuConfig(Ort::SessionOptions& options, const CpuConfig& c) {
+    if (c.sessions == 1 && c.threads == g_intra_threads && !c.parallel) {
+        ApplyThreading(options);
+    } else {
+        options.SetIntraOpNumThreads(std::max(1, c.threads / c.sessions));
+        if (c.parallel) {
+            options.SetExecutionMode(ExecutionMode::ORT_PARALLEL);
+            options.SetInterOpNumThreads(std::max(2, g_inter_threads));
+        }
+        ApplySpinning(options);
+    }
+    if (!c.arena)
+        options.DisableCpuMemArena();
+    else if (g_env_arena)
+        options.AddConfigEntry(kOrtSessionOptionsConfigUseEnvAllocators, "1");
+    options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+}
+
+// INT8 (QDQ or QOperator) models. Let the optimizer fuse signed-int8 QDQ
+// groups into integer kernels on x86 too (the default only does so on ARM),
+// and with AE_YOLO_INT8_PRECISE=1 use the slower U8U8 GEMM that cannot
+// saturate on AVX2/AVX-512 CPUs without VNNI. Both only affect quantized ops.
+static bool IsQuantizedModelFile(const fs::path& model_file) {
+    std::string name = model_file.filename().u8string();
+    std::transform(name.begin(), name.end(), name.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return name.find("int8") != std::string::npos;
+}
+
+static void ApplyQuantizedOptions(Ort::SessionOptions& options) {
+    options.AddConfigEntry(kOrtSessionOptionsQDQIsInt8Allowed, "1");
+    if (GetEnvInt("AE_YOLO_INT8_PRECISE", 0) > 0)
+        options.AddConfigEntry(kOrtSessionOptionsAvx2PrecisionMode, "1");
+}
+
+// Options for an Analyze run: the shrinking ones while SetArenaShrinkage is on.
+static const Ort::RunOptions& AnalysisRunOptions() {
+    return g_shrink_runs ? *g_shrink_run_options : *g_run_options;
+}
+
+// A Run that stopped because of RequestCancel is not an error worth a warning.
+static void LogRunError(const char* where, const Ort::Exception& e) {
+    if (g_cancel_requested)
+        DebugLog(std::string(where) + ": cancelled");
+    else
+        DebugLog(std::string(where) + " failed: " + e.what());
+}
+
 // ============================================================================
-// Public API
+// FP16 tensors
 // ============================================================================
-void YoloEngine::EnsureSession(const char* model_path_utf8, bool use_gpu) {
-    std::lock_guard<std::mutex> lock(GetMutex());
+// Float16 and Ort::Float16_t are both onnxruntime_float16::Float16Impl with a
+// single uint16_t, so half buffers are handed to ORT without conversion.
+static_assert(sizeof(Float16) == sizeof(Ort::Float16_t), "Float16 must match Ort::Float16_t");
 
-    std::call_once(g_init_flag, InitializeInternal);
-    if (!g_initialized) return;
+static Ort::Value HalfTensor(const Ort::MemoryInfo& mem_info, std::vector<Float16>& values,
+                             const int64_t* shape, size_t rank) {
+    return Ort::Value::CreateTensor<Ort::Float16_t>(
+        mem_info, reinterpret_cast<Ort::Float16_t*>(values.data()), values.size(), shape, rank);
+}
 
-    if (g_session_ready &&
-        g_current_model_path == model_path_utf8 &&
-        g_current_use_gpu == use_gpu) {
-        return;
+// [1, 3, H, W] (or [1, H, W, 3] uint8) tensor over the session's zero-copy
+// input buffer.
+static Ort::Value BoundInputTensor(CachedSession& s, const Ort::MemoryInfo& mem_info) {
+    if (s.rgb8_input) {
+        const int64_t nhwc_shape[] = { 1, s.input_h, s.input_w, 3 };
+        return Ort::Value::CreateTensor<uint8_t>(
+            mem_info, s.bound_input_rgb8.data(), s.bound_input_rgb8.size(), nhwc_shape, 4);
     }
+    const int64_t input_shape[] = { 1, 3, s.input_h, s.input_w };
+    if (s.half_input) return HalfTensor(mem_info, s.bound_input_half, input_shape, 4);
+    return Ort::Value::CreateTensor<float>(
+        mem_info, s.bound_input.data(), s.bound_input.size(), input_shape, 4);
+}
 
-    g_session.reset();
-    g_options.reset();
-    g_session_ready = false;
+// Float [N, 3, H, W] input for the copying paths: used as is, narrowed for
+// FP16 models, or rounded to bytes and interleaved to [N, H, W, 3] for uint8
+// models. Converted data lives in `scratch`, which must outlive the tensor.
+static Ort::Value CopyInputTensor(const CachedSession& s, const Ort::MemoryInfo& mem_info,
+                                  const float* values, size_t count, ConvertedInput& scratch,
+                                  const int64_t* shape, size_t rank) {
+    if (s.rgb8_input && rank == 4) {
+        const size_t plane = static_cast<size_t>(shape[2]) * static_cast<size_t>(shape[3]);
+        scratch.rgb8.resize(count);
+        for (size_t image = 0; image < count / (plane * 3); image++) {
+            const float* chw = values + image * plane * 3;
+            unsigned char* hwc = scratch.rgb8.data() + image * plane * 3;
+            for (size_t i = 0; i < plane; i++)
+                for (int c = 0; c < 3; c++) {
+                    float v = std::min(std::max(chw[c * plane + i], 0.0f), 1.0f);
+                    hwc[i * 3 + c] = static_cast<unsigned char>(v * 255.0f + 0.5f);
+                }
+        }
+        const int64_t nhwc_shape[] = { shape[0], shape[2], shape[3], 3 };
+        return Ort::Value::CreateTensor<uint8_t>(
+            mem_info, scratch.rgb8.data(), scratch.rgb8.size(), nhwc_shape, 4);
+    }
+    if (s.half_input) {
+        scratch.half.resize(count);
+        for (size_t i = 0; i < count; i++) scratch.half[i] = Float16(values[i]);
+        return HalfTensor(mem_info, scratch.half, shape, rank);
+    }
+    return Ort::Value::CreateTensor<float>(
+        mem_info, const_cast<float*>(values), count, shape, rank);
+}
 
-    DebugLog(std::string("EnsureSession: loading model: ") + model_path_utf8);
+// Copy an output value into a float vector, widening FP16 outputs.
+static void CopyOutput(const Ort::Value& value, std::vector<float>& raw_output,
+                       std::vector<int64_t>& out_shape) {
+    auto type_info = value.GetTensorTypeAndShapeInfo();
+    out_shape = type_info.GetShape();
+    size_t count = type_info.GetElementCount();
+    if (type_info.GetElementType() == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16) {
+        const Float16* data = static_cast<const Float16*>(value.GetTensorRawData());
+        raw_output.resize(count);
+        for (size_t i = 0; i < count; i++) raw_output[i] = data[i].ToFloat();
+    } else {
+        const float* data = value.GetTensorData<float>();
+        raw_output.assign(data, data + count);
+    }
+}
 
+// ============================================================================
+// IoBinding (CPU EP)
+// ============================================================================
+// Bind bound_input as the [1, 3, H, W] input and, when the output shape is
+// static (a symbolic batch dim counts as 1), a preallocated output buffer.
+// Outputs with other symbolic dims (e.g. a variable detection count) are bound
+// to the CPU allocator instead: ORT allocates them per run, but they are still
+// read in place.
+static void BindSessionBuffers(CachedSession& s) {
+    s.binding.reset();
+    s.bound_output.clear();
+    s.bound_output_half.clear();
+    s.bound_output_shape.clear();
     try {
-        g_options = std::make_unique<Ort::SessionOptions>();
-        g_options->SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+        Ort::MemoryInfo mem_info = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+        s.binding = std::make_unique<Ort::IoBinding>(*s.session);
 
-        bool gpu_ok = false;
-        if (use_gpu) {
-#ifdef _WIN32
-            // Windows: DirectML GPU acceleration
-            try {
-                g_options->DisableMemPattern();
-                g_options->SetExecutionMode(ExecutionMode::ORT_SEQUENTIAL);
-
-                OrtStatus* dml_status = OrtSessionOptionsAppendExecutionProvider_DML(
-                    *g_options, 0);
-                if (dml_status) {
-                    const char* err = Ort::Global<void>::api_->GetErrorMessage(dml_status);
-                    DebugLog(std::string("DirectML failed: ") + (err ? err : "unknown"));
-                    Ort::Global<void>::api_->ReleaseStatus(dml_status);
+        s.binding->BindInput(s.input_name.c_str(), BoundInputTensor(s, mem_info));
+
+        std::vector<int64_t> out_shape =
+            s.session->GetOutputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+        if (!out_shape.empty() && out_shape[0] <= 0) out_shape[0] = 1;
+        bool is_static = !out_shape.empty();
+        size_t out_count = 1;
+        for (int64_t d : out_shape) {
+            if (d <= 0) is_static = false;
+            else out_count *= static_cast<size_t>(d);
+        }
+
+        if (is_static) {
+            s.bound_output_shape = out_shape;
+            if (s.half_output) {
+                s.bound_output_half.assign(out_count, Float16());
+                s.binding->BindOutput(s.output_name.c_str(), HalfTensor(
+                    mem_info, s.bound_output_half, s.bound_output_shape.data(), s.bound_output_shape.size()));
+            } else {
+                s.bound_output.assign(out_count, 0.0f);
+                s.binding->BindOutput(s.output_name.c_str(), Ort::Value::CreateTensor<float>(
+                    mem_info, s.bound_output.data(), s.bound_output.size(),
+                    s.bound_output_shape.data(), s.bound_output_shape.size()));
+            }
+            DebugLog("EnsureSession: IoBinding with preallocated output (" +
+                     std::to_string(out_count) + (s.half_output ? " halves)" : " floats)"));
+        } else {
+            s.binding->BindOutput(s.output_name.c_str(), mem_info);
+            DebugLog("EnsureSession: IoBinding with ORT-allocated output (dynamic shape)");
+        }
+    } catch (const Ort::Exception& e) {
+        DebugLog(std::string("EnsureSession: IoBinding unavailable, using plain Run: ") + e.what());
+        s.binding.reset();
+        s.bound_output.clear();
+        s.bound_output_half.clear();
+        s.bound_output_shape.clear();
+    }
+}
+
+// ============================================================================
+// Single-image run on the session's own buffers
+// ============================================================================
+// Run s on its bound input ([1, 3, H, W]) and view the output in place. With a
+// binding the output is the preallocated buffer or an ORT-allocated value;
+// without one (GPU EPs) it is the value returned by Run. Either way it stays
+// valid until the next run on s.
+static bool RunBound(CachedSession& s, const Ort::RunOptions& run_options, TensorView& output) {
+    try {
+        if (s.binding) {
+            s.session->Run(run_options, *s.binding);
+            if (!s.bound_output_shape.empty()) {
+                if (s.half_output) {
+                    output.data = s.bound_output_half.data();
+                    output.type = TensorElement::Float16;
                 } else {
-                    gpu_ok = true;
-                    DebugLog("EnsureSession: DirectML execution provider added (device 0)");
+                    output.data = s.bound_output.data();
+                    output.type = TensorElement::Float32;
                 }
-            } catch (const Ort::Exception& e) {
-                DebugLog(std::string("DirectML exception: ") + e.what());
+                output.shape = s.bound_output_shape.data();
+                output.rank  = static_cast<int>(s.bound_output_shape.size());
+                return true;
             }
+            s.last_outputs = s.binding->GetOutputValues();
+        } else {
+            static Ort::MemoryInfo mem_info =
+                Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPUInput);
+            Ort::Value input_tensor = BoundInputTensor(s, mem_info);
+
+            const char* input_names[]  = { s.input_name.c_str() };
+            const char* output_names[] = { s.output_name.c_str() };
+            s.last_outputs = s.session->Run(
+                run_options,
+                input_names, &input_tensor, 1,
+                output_names, 1);
+        }
+
+        // View the output value in place; it lives until the next run.
+        auto type_info = s.last_outputs[0].GetTensorTypeAndShapeInfo();
+        s.last_output_shape = type_info.GetShape();
+        output.data  = s.last_outputs[0].GetTensorRawData();
+        output.type  = type_info.GetElementType() == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16
+                           ? TensorElement::Float16 : TensorElement::Float32;
+        output.shape = s.last_output_shape.data();
+        output.rank  = static_cast<int>(s.last_output_shape.size());
+        return true;
+    } catch (const Ort::Exception& e) {
+        LogRunError("RunInference", e);
+        return false;
+    } catch (...) {
+        DebugLog("RunInference: unknown exception");
+        return false;
+    }
+}
+
+// Fill the bound input with letterbox gray, for runs whose output is unused.
+static void FillInputGray(CachedSession& s) {
+    std::fill(s.bound_input.begin(), s.bound_input.end(), 114.0f / 255.0f);
+    std::fill(s.bound_input_half.begin(), s.bound_input_half.end(), Float16(114.0f / 255.0f));
+    std::fill(s.bound_input_rgb8.begin(), s.bound_input_rgb8.end(), static_cast<unsigned char>(114));
+}
+
+// One dummy inference on a letterbox-gray frame, so kernel selection, arena
+// growth and (on GPU) shader compilation happen at load time rather than on
+// the first analyzed frame. Called once per input shape.
+static void WarmUpSession(CachedSession& s) {
+    FillInputGray(s);
+    TensorView output;
+    if (RunBound(s, Ort::RunOptions{nullptr}, output))
+        DebugLog("EnsureSession: warm-up inference done (" + std::to_string(s.input_w) +
+                 "x" + std::to_string(s.input_h) + ")");
+    s.warmed_shapes.emplace_back(s.input_w, s.input_h);
+}
+
+// ============================================================================
+// Session loading
+// ============================================================================
+// Cache tag for the EP a session runs on. Optimized graphs are EP-specific.
+static const char* ExecutionProviderTag(bool gpu_ok) {
+#ifdef _WIN32
+    return gpu_ok ? "dml" : "cpu";
 #elif defined(__APPLE__)
-            // macOS: CoreML GPU/ANE acceleration
-            try {
-                OrtStatus* cml_status = OrtSessionOptionsAppendExecutionProvider_CoreML(
-                    *g_options, 0);
-                if (cml_status) {
-                    const char* err = Ort::Global<void>::api_->GetErrorMessage(cml_status);
-                    DebugLog(std::string("CoreML failed: ") + (err ? err : "unknown"));
-                    Ort::Global<void>::api_->ReleaseStatus(cml_status);
-                } else {
-                    gpu_ok = true;
-                    DebugLog("EnsureSession: CoreML execution provider added");
+    return gpu_ok ? "coreml" : "cpu";
+#else
+    (void)gpu_ok;
+    return "cpu";
+#endif
+}
+
+// Instruction set the CPU kernels use. A CPU entry saved at ORT_ENABLE_ALL
+// holds the NCHWc layout, whose block size MLAS picks per CPU (8 floats on
+// AVX2, 16 on AVX-512), so CPU entries are keyed on it.
+static const char* CpuIsaTag() {
+#if defined(_M_X64) || defined(__x86_64__)
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return "sse";
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx     = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx) return "sse";
+    const unsigned long long xcr0 = _xgetbv(0);
+    __cpuidex(info, 7, 0);
+    if ((info[1] & (1 << 16)) && (xcr0 & 0xE6) == 0xE6) return "avx512";
+    if ((info[1] & (1 << 5)) && (xcr0 & 0x6) == 0x6) return "avx2";
+    return "sse";
+#else
+    if (__builtin_cpu_supports("avx512f")) return "avx512";
+    if (__builtin_cpu_supports("avx2")) return "avx2";
+    return "sse";
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    return "neon";
+#else
+    return "generic";
+#endif
+}
+
+// Model cache tag: the GPU EP's, or "cpu_<ISA>" for CPU entries.
+static std::string CacheTag(bool gpu_ok) {
+    if (gpu_ok) return ExecutionProviderTag(true);
+    return std::string(ExecutionProviderTag(false)) + "_" + CpuIsaTag();
+}
+
+// Attach the platform's GPU EP (DirectML on Windows, CoreML on macOS) to
+// options. Returns false if there is none or it failed to attach.
+static bool AppendGpuProvider(Ort::SessionOptions& options) {
+    bool gpu_ok = false;
+#ifdef _WIN32
+    // Windows: DirectML GPU acceleration
+    try {
+        options.DisableMemPattern();
+        options.SetExecutionMode(ExecutionMode::ORT_SEQUENTIAL);
+
+        OrtStatus* dml_status = OrtSessionOptionsAppendExecutionProvider_DML(options, 0);
+        if (dml_status) {
+            const char* err = Ort::Global<void>::api_->GetErrorMessage(dml_status);
+            DebugLog(std::string("DirectML failed: ") + (err ? err : "unknown"));
+            Ort::Global<void>::api_->ReleaseStatus(dml_status);
+        } else {
+            gpu_ok = true;
+            DebugLog("EnsureSession: DirectML execution provider added (device 0)");
+        }
+    } catch (const Ort::Exception& e) {
+        DebugLog(std::string("DirectML exception: ") + e.what());
+    }
+#elif defined(__APPLE__)
+    // macOS: CoreML GPU/ANE acceleration
+    try {
+        OrtStatus* cml_status = OrtSessionOptionsAppendExecutionProvider_CoreML(options, 0);
+        if (cml_status) {
+            const char* err = Ort::Global<void>::api_->GetErrorMessage(cml_status);
+            DebugLog(std::string("CoreML failed: ") + (err ? err : "unknown"));
+            Ort::Global<void>::api_->ReleaseStatus(cml_status);
+        } else {
+            gpu_ok = true;
+            DebugLog("EnsureSession: CoreML execution provider added");
+        }
+    } catch (const Ort::Exception& e) {
+        DebugLog(std::string("CoreML exception: ") + e.what());
+    }
+#else
+    (void)options;
+#endif
+    return gpu_ok;
+}
+
+// Run graph optimization once, offline, and save the result as an ORT-format
+// model cache entry. A session loading an ORT-format model runs no graph
+// transformers, so the entry must already hold every pass the session would
+// apply: CPU entries are saved at ALL, layout transforms included, and keyed
+// on the CPU's ISA (CacheTag). GPU entries (opt-in, see g_cache_gpu) are
+// saved at BASIC, the level the GPU EPs accept in an ORT-format model.
+static bool WriteOptimizedModel(const fs::path& model_file, const fs::path& entry,
+                                const char* ep_tag, bool gpu_target) {
+    fs::path temp = ModelCache::TempPath(entry);
+    if (temp.empty()) return false;
+    try {
+        Ort::SessionOptions options;
+        ApplyThreading(options);
+        options.SetGraphOptimizationLevel(gpu_target ? GraphOptimizationLevel::ORT_ENABLE_BASIC
+                                                     : GraphOptimizationLevel::ORT_ENABLE_ALL);
+        if (IsQuantizedModelFile(model_file)) ApplyQuantizedOptions(options);
+        options.AddConfigEntry(kOrtSessionOptionsConfigSaveModelFormat, "ORT");
+        options.SetOptimizedModelFilePath(temp.c_str());
+        Ort::Session optimizer(*g_env, model_file.c_str(), options);
+    } catch (const Ort::Exception& e) {
+        DebugLog(std::string("EnsureSession: could not write optimized model: ") + e.what());
+        ModelCache::Invalidate(temp);
+        return false;
+    }
+    if (!ModelCache::Commit(temp, entry, ep_tag)) return false;
+    DebugLog("EnsureSession: saved optimized model to cache: " + entry.u8string());
+    return true;
+}
+
+// The model cache entry for model_file on the CPU or the GPU EP, written
+// first on a miss. Empty when the cache is disabled, the write failed, or
+// for the GPU EP unless AE_YOLO_MODEL_CACHE_GPU is on.
+static fs::path CachedModelFor(const fs::path& model_file, bool gpu_ok) {
+    if (gpu_ok && !g_cache_gpu) return fs::path();
+    const std::string ep_tag = CacheTag(gpu_ok);
+    fs::path cached = ModelCache::EntryPath(model_file, Ort::GetVersionString(), ep_tag.c_str());
+    if (!cached.empty() && !fs::exists(cached) &&
+        !WriteOptimizedModel(model_file, cached, ep_tag.c_str(), gpu_ok)) {
+        cached.clear();
+    }
+    return cached;
+}
+
+// Rough resident size of a session: the weights, about as much again for
+// optimized/prepacked copies and the arena, plus our own IO buffers. Replicas
+// share the prepacked weights but each has its own graph copy and arena. A
+// mapped model's weights are shared, reclaimable page cache and not counted.
+static size_t EstimateSessionBytes(const CachedSession& s) {
+    std::error_code ec;
+    auto file_bytes = std::filesystem::file_size(std::filesystem::u8path(s.model_path), ec);
+    size_t copies = s.mapped_model ? 1 : 2 + s.replicas.size();
+    size_t bytes = ec ? 0 : static_cast<size_t>(file_bytes) * copies;
+    bytes += (s.input_buffer.capacity() + s.bound_input.capacity() +
+              s.bound_output.capacity()) * sizeof(float);
+    bytes += (s.input_converted.half.capacity() + s.bound_input_half.capacity() +
+              s.bound_output_half.capacity()) * sizeof(Float16);
+    bytes += s.input_converted.rgb8.capacity() + s.bound_input_rgb8.capacity();
+    return bytes;
+}
+
+// True if entry s can serve a request for (model_path, use_gpu, input_size).
+// Fixed-shape models have a single size, so any requested size matches.
+static bool SessionMatches(const CachedSession& s, const char* model_path_utf8,
+                           bool use_gpu, int input_size) {
+    if (s.model_path != model_path_utf8 || s.use_gpu != use_gpu) return false;
+    if (!s.dynamic_input) return true;
+    return s.input_size == (input_size > 0 ? input_size : kDefaultInputSize);
+}
+
+// ============================================================================
+// Auto-tuning
+// ============================================================================
+// Throughput in frames/s of `sessions` sessions of file with options, all
+// running at once on a zero-filled [batch, 3, H, W] input (symbolic H/W at
+// input_size). 0 if the sessions cannot be created or run, e.g. batch > 1 on
+// a model with a fixed batch axis, or once keep_going returns false (it is
+// asked between session loads and timed rounds).
+static double MeasureFps(const fs::path& file, const Ort::SessionOptions& options, int sessions,
+                         int batch, int input_size, OrtPrepackedWeightsContainer* prepacked,
+                         const std::function<bool()>& keep_going) {
+    try {
+        std::vector<std::unique_ptr<Ort::Session>> loaded;
+        for (int k = 0; k < sessions; k++) {
+            if (!keep_going()) return 0.0;
+            loaded.push_back(prepacked
+                ? std::make_unique<Ort::Session>(*g_env, file.c_str(), options, prepacked)
+                : std::make_unique<Ort::Session>(*g_env, file.c_str(), options));
+        }
+
+        auto tensor_info = loaded[0]->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo();
+        const ONNXTensorElementDataType type = tensor_info.GetElementType();
+        std::vector<int64_t> shape = tensor_info.GetShape();
+        if (shape.empty()) return 0.0;
+        if (shape[0] > 0 && shape[0] != batch) return 0.0;
+        shape[0] = batch;
+        size_t count = 1;
+        for (auto& d : shape) {
+            if (d <= 0) d = input_size;
+            count *= static_cast<size_t>(d);
+        }
+
+        static Ort::MemoryInfo mem_info =
+            Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPUInput);
+        std::vector<float>          input_float;
+        std::vector<Float16>        input_half;
+        std::vector<unsigned char>  input_rgb8;
+        Ort::Value input{nullptr};
+        if (type == ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8) {
+            input_rgb8.assign(count, 0);
+            input = Ort::Value::CreateTensor<uint8_t>(mem_info, input_rgb8.data(), count,
+                                                      shape.data(), shape.size());
+        } else if (type == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16) {
+            input_half.assign(count, Float16());
+            input = HalfTensor(mem_info, input_half, shape.data(), shape.size());
+        } else {
+            input_float.assign(count, 0.0f);
+            input = Ort::Value::CreateTensor<float>(mem_info, input_float.data(), count,
+                                                    shape.data(), shape.size());
+        }
+
+        Ort::AllocatorWithDefaultOptions alloc;
+        const std::string input_name  = loaded[0]->GetInputNameAllocated(0, alloc).get();
+        const std::string output_name = loaded[0]->GetOutputNameAllocated(0, alloc).get();
+        const char* input_names[]  = { input_name.c_str() };
+        const char* output_names[] = { output_name.c_str() };
+
+        // One Run on every session at once, like RunOnReplicas.
+        auto run_all = [&]() {
+            std::atomic<bool> ok{true};
+            ThreadPool::Shared().ParallelFor(sessions, sessions, [&](int begin, int end) {
+                for (int k = begin; k < end; k++) {
+                    try {
+                        loaded[k]->Run(Ort::RunOptions{nullptr}, input_names, &input, 1, output_names, 1);
+                    } catch (const Ort::Exception& e) {
+                        DebugLog(std::string("AutoTune: run failed: ") + e.what());
+                        ok = false;
+                    }
                 }
-            } catch (const Ort::Exception& e) {
-                DebugLog(std::string("CoreML exception: ") + e.what());
+            });
+            return ok.load();
+        };
+
+        // One warm-up round, then at least two timed rounds, stopping after
+        // about a second (slow models) or five rounds (fast ones).
+        if (!run_all()) return 0.0;
+        using clock = std::chrono::steady_clock;
+        const auto start = clock::now();
+        int rounds = 0;
+        double seconds = 0.0;
+        while (rounds < 5 && (rounds < 2 || seconds < 1.0)) {
+            if (!keep_going() || !run_all()) return 0.0;
+            rounds++;
+            seconds = std::chrono::duration<double>(clock::now() - start).count();
+        }
+        return seconds > 0.0 ? rounds * sessions * batch / seconds : 0.0;
+    } catch (const Ort::Exception& e) {
+        DebugLog(std::string("AutoTune: configuration unusable: ") + e.what());
+        return 0.0;
+    }
+}
+
+// Benchmark a small grid of CPU configurations around the defaults (and the
+// GPU EP if requested) and return the winner. A configuration has to beat
+// the defaults by 5% to replace them, so timing noise does not move a
+// machine off the configuration every other machine runs. progress(step,
+// steps) reports the configuration being measured; when it returns false the
+// tune stops and returns an empty profile (fps 0).
+static TuneProfile::Profile TuneModel(const fs::path& model_file, bool quantized, bool try_gpu,
+                                      int input_size, const std::function<bool(int, int)>& progress) {
+    const auto start = std::chrono::steady_clock::now();
+    const int hw = g_intra_threads;
+    std::vector<CpuConfig> grid;
+    grid.push_back(DefaultCpuConfig());                  // baseline: 1 session, all threads
+    if (hw >= 4) {                                       // half the threads (SMT siblings idle)
+        CpuConfig c = grid[0];
+        c.threads = hw / 2;
+        grid.push_back(c);
+    }
+    for (int k : { 2, 4 }) {                             // K sessions of at least 4 threads
+        if (hw / k < 4) continue;
+        CpuConfig c = grid[0];
+        c.sessions = c.batch = k;
+        grid.push_back(c);
+    }
+    CpuConfig parallel = grid[0];
+    parallel.parallel = true;
+    grid.push_back(parallel);
+    CpuConfig no_arena = grid[0];
+    no_arena.arena = false;
+    grid.push_back(no_arena);
+    CpuConfig batched = grid[0];                         // dynamic-batch models only
+    batched.batch = 4;
+    grid.push_back(batched);
+
+    // Benchmark on the cache entries the real sessions will load.
+    fs::path cpu_file = CachedModelFor(model_file, false);
+    const bool cpu_cached = !cpu_file.empty();
+    if (!cpu_cached) cpu_file = model_file;
+
+    const int steps = static_cast<int>(grid.size()) + (try_gpu ? 1 : 0);
+    int step = 0;
+    bool cancelled = false;
+    auto keep_going = [&]() {
+        cancelled = cancelled || !progress(step, steps);
+        return !cancelled;
+    };
+
+    CpuConfig best = grid[0];
+    best.batch = 1;
+    double baseline_fps = 0.0, best_fps = 0.0;
+    for (size_t i = 0; i < grid.size(); i++, step++) {
+        CpuConfig c = grid[i];
+        if (c.batch <= 0) c.batch = 1;
+        Ort::SessionOptions options;
+        ApplyCpuConfig(options, c);
+        if (quantized) ApplyQuantizedOptions(options);
+        if (cpu_cached) options.AddConfigEntry(kOrtSessionOptionsConfigLoadModelFormat, "ORT");
+        double fps = MeasureFps(cpu_file, options, c.sessions, std::max(1, c.batch / c.sessions),
+                                input_size, g_prepacked.get(), keep_going);
+        if (cancelled) return TuneProfile::Profile();
+        DebugLog("AutoTune: CPU " + DescribeCpuConfig(c) + ": " +
+                 (fps > 0.0 ? std::to_string(fps) + " fps" : std::string("not applicable")));
+        if (i == 0) {
+            baseline_fps = best_fps = fps;
+        } else if (fps > best_fps && fps > baseline_fps * 1.05) {
+            best = c;
+            best_fps = fps;
+        }
+    }
+
+    TuneProfile::Profile profile;
+    profile.threads  = best.threads;
+    profile.sessions = best.sessions;
+    profile.batch    = best.batch;
+    profile.parallel = best.parallel;
+    profile.arena    = best.arena;
+    profile.fps      = best_fps;
+
+    if (try_gpu) {
+        Ort::SessionOptions options;
+        ApplyThreading(options);
+        options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+        if (AppendGpuProvider(options)) {
+            if (g_env_arena) options.AddConfigEntry(kOrtSessionOptionsConfigUseEnvAllocators, "1");
+            fs::path gpu_file = CachedModelFor(model_file, true);
+            if (!gpu_file.empty()) options.AddConfigEntry(kOrtSessionOptionsConfigLoadModelFormat, "ORT");
+            double fps = MeasureFps(gpu_file.empty() ? model_file : gpu_file, options, 1, 1,
+                                    input_size, nullptr, keep_going);
+            if (cancelled) return TuneProfile::Profile();
+            DebugLog("AutoTune: " + std::string(ExecutionProviderTag(true)) + ": " +
+                     std::to_string(fps) + " fps");
+            if (fps > 0.0 && fps >= best_fps) {
+                profile.use_gpu = true;
+                profile.fps     = fps;
             }
-#endif
+        }
+    }
+
+    DebugLog("AutoTune: picked " +
+             (profile.use_gpu ? std::string(ExecutionProviderTag(true)) : "CPU " + DescribeCpuConfig(best)) +
+             " in " + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::steady_clock::now() - start).count()) + " ms");
+    return profile;
+}
+
+// Queue a tune for RunPendingTune unless one for the same profile is queued.
+static void ScheduleTune(TuneRequest request) {
+    std::lock_guard<std::mutex> lock(g_tune_mutex);
+    for (auto& queued : g_tune_queue)
+        if (queued.profile_file == request.profile_file) return;
+    DebugLog("AutoTune: no profile for this model and machine, tuning at the next Analyze");
+    g_tune_queue.push_back(std::move(request));
+}
+
+// The saved profile for this model, ORT version, machine and EP request.
+// Returns false when auto-tuning is off, the model cache is disabled or no
+// profile exists yet; the caller then uses the defaults. A missing profile
+// queues a tune for the next Analyze (RunPendingTune). Never tunes inline:
+// loads run on the AE UI thread and under the engine mutex.
+static bool LoadTuneProfile(const fs::path& model_file, bool quantized, bool try_gpu,
+                            int input_size, TuneProfile::Profile& profile) {
+    if (!g_autotune) return false;
+    const fs::path file = TuneProfile::PathFor(model_file, Ort::GetVersionString(), try_gpu ? "gpu" : "cpu");
+    if (file.empty()) return false;
+    if (TuneProfile::Load(file, profile)) {
+        DebugLog("EnsureSession: tuned profile " + file.u8string());
+        return true;
+    }
+
+    TuneRequest request;
+    request.model_file   = model_file;
+    request.profile_file = file;
+    request.quantized    = quantized;
+    request.try_gpu      = try_gpu;
+    request.input_size   = input_size;
+    ScheduleTune(std::move(request));
+    return false;
+}
+
+// ============================================================================
+// Model loading
+// ============================================================================
+// Load a model into a new cache entry. Returns null on failure.
+static std::unique_ptr<CachedSession> LoadSession(const char* model_path_utf8,
+                                                  bool use_gpu, int input_size) {
+    DebugLog(std::string("EnsureSession: loading model: ") + model_path_utf8);
+
+    auto s = std::make_unique<CachedSession>();
+    s->model_path = model_path_utf8;
+    s->use_gpu = use_gpu;
+
+    try {
+        s->options = std::make_unique<Ort::SessionOptions>();
+        ApplyThreading(*s->options);
+        s->options->SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+
+        // INT8 models are for CPU-only render nodes; the GPU EPs run them no
+        // faster than the float model, so they always take the CPU path.
+        const fs::path model_file = fs::u8path(model_path_utf8);
+        const bool quantized = IsQuantizedModelFile(model_file);
+
+        // A tuned profile (see LoadTuneProfile) may prefer the CPU even
+        // when a GPU EP is available, and picks the CPU configuration.
+        TuneProfile::Profile profile;
+        const bool tuned = LoadTuneProfile(model_file, quantized, use_gpu && !quantized,
+                                           input_size, profile);
+
+        bool gpu_ok = false;
+        if (use_gpu && !quantized) {
+            if (!tuned || profile.use_gpu)
+                gpu_ok = AppendGpuProvider(*s->options);
+            else
+                DebugLog("EnsureSession: tuned profile prefers the CPU execution provider");
         }
 
         if (!gpu_ok) {
-            g_options = std::make_unique<Ort::SessionOptions>();
-            g_options->SetIntraOpNumThreads(4);
-            g_options->SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
-            DebugLog("EnsureSession: using CPU execution provider");
+            s->cpu = tuned ? CpuConfigFromProfile(profile) : DefaultCpuConfig();
+            s->options = std::make_unique<Ort::SessionOptions>();
+            ApplyCpuConfig(*s->options, s->cpu);
+            DebugLog("EnsureSession: using CPU execution provider (" + DescribeCpuConfig(s->cpu) +
+                     (tuned ? ", tuned)" : ")"));
         }
+        s->gpu_ok = gpu_ok;
+        if (gpu_ok && g_env_arena)   // CPU sessions: see ApplyCpuConfig
+            s->options->AddConfigEntry(kOrtSessionOptionsConfigUseEnvAllocators, "1");
 
-        // Create session — Windows uses wide path, macOS/Linux use UTF-8
-#ifdef _WIN32
-        int wlen = MultiByteToWideChar(CP_UTF8, 0, model_path_utf8, -1, NULL, 0);
-        std::wstring wide_path(static_cast<size_t>(wlen), L'\0');
-        MultiByteToWideChar(CP_UTF8, 0, model_path_utf8, -1, &wide_path[0], wlen);
-        g_session = std::make_unique<Ort::Session>(*g_env, wide_path.c_str(), *g_options);
-#else
-        g_session = std::make_unique<Ort::Session>(*g_env, model_path_utf8, *g_options);
-#endif
+        if (quantized) {
+            ApplyQuantizedOptions(*s->options);
+            DebugLog("EnsureSession: INT8 model, quantized kernels enabled");
+        }
 
-        // Auto-detect input size from model shape [N, 3, H, W]
-        Ort::TypeInfo input_info = g_session->GetInputTypeInfo(0);
+        // Create session. fs::path::c_str() is the wide path ORT wants on
+        // Windows and UTF-8 on macOS/Linux. Prefer the pre-optimized ORT-format
+        // copy from the model cache, writing it first on a cache miss.
+        fs::path cached = CachedModelFor(model_file, gpu_ok);
+        // GPU EP kernels do not prepack on the CPU, so only CPU sessions take
+        // the shared container.
+        OrtPrepackedWeightsContainer* prepacked = gpu_ok ? nullptr : g_prepacked.get();
+        auto open_session = [&](const fs::path& file, const Ort::SessionOptions& options) {
+            if (prepacked)
+                return std::make_unique<Ort::Session>(*g_env, file.c_str(), options, prepacked);
+            return std::make_unique<Ort::Session>(*g_env, file.c_str(), options);
+        };
+        // The cache entry, from its mapped bytes when the model is mapped.
+        auto open_cached = [&](const Ort::SessionOptions& options) {
+            if (!s->mapped_model) return open_session(cached, options);
+            const void* bytes = s->mapped_model->data();
+            size_t      size  = s->mapped_model->size();
+            if (prepacked)
+                return std::make_unique<Ort::Session>(*g_env, bytes, size, options, prepacked);
+            return std::make_unique<Ort::Session>(*g_env, bytes, size, options);
+        };
+        Ort::SessionOptions load_options{nullptr};
+        bool from_cache = false;
+        if (!cached.empty()) {
+            try {
+                load_options = s->options->Clone();
+                load_options.AddConfigEntry(kOrtSessionOptionsConfigLoadModelFormat, "ORT");
+                if (g_mmap_models) {
+                    // The sessions keep pointers into the map, which therefore
+                    // lives as long as the cache entry (see CachedSession).
+                    s->mapped_model = MappedFile::Open(cached);
+                    if (s->mapped_model) {
+                        load_options.AddConfigEntry(kOrtSessionOptionsConfigUseORTModelBytesDirectly, "1");
+                        load_options.AddConfigEntry(kOrtSessionOptionsConfigUseORTModelBytesForInitializers, "1");
+                    } else {
+                        DebugLog("EnsureSession: could not map cached model, reading it instead");
+                    }
+                }
+                s->session = open_cached(load_options);
+                from_cache = true;
+                DebugLog("EnsureSession: loaded optimized model from cache: " + cached.u8string() +
+                         (s->mapped_model ? " (memory-mapped)" : ""));
+            } catch (const Ort::Exception& e) {
+                DebugLog(std::string("EnsureSession: cached model unusable, removing: ") + e.what());
+                s->mapped_model.reset();
+                ModelCache::Invalidate(cached);
+            }
+        }
+        if (!s->session)
+            s->session = open_session(model_file, *s->options);
+
+        // Parallel CPU sessions: same file and options as the first.
+        if (!gpu_ok && s->cpu.sessions > 1) {
+            for (int k = 1; k < s->cpu.sessions; k++) {
+                s->replicas.push_back(from_cache ? open_cached(load_options)
+                                                 : open_session(model_file, *s->options));
+            }
+            DebugLog("EnsureSession: " + std::to_string(s->cpu.sessions) + " parallel CPU sessions x " +
+                     std::to_string(std::max(1, s->cpu.threads / s->cpu.sessions)) + " threads");
+        }
+
+        // Auto-detect input size from model shape [N, 3, H, W], or [N, H, W, 3]
+        // for uint8 models with the normalization folded in
+        Ort::TypeInfo input_info = s->session->GetInputTypeInfo(0);
         auto tensor_info = input_info.GetTensorTypeAndShapeInfo();
         auto shape = tensor_info.GetShape();
+        s->rgb8_input = tensor_info.GetElementType() == ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8 &&
+                        shape.size() == 4 && shape[3] == 3;
+        if (s->rgb8_input) {
+            shape = { shape[0], 3, shape[1], shape[2] };
+            DebugLog("EnsureSession: uint8 NHWC input (normalization in graph)");
+        }
         if (shape.size() == 4 && shape[2] > 0 && shape[3] > 0) {
-            g_input_size = static_cast<int>(shape[2]);
-            DebugLog("EnsureSession: input size from model = " + std::to_string(g_input_size));
+            s->input_size = static_cast<int>(shape[2]);
+            s->dynamic_input = false;
+            DebugLog("EnsureSession: input size from model = " + std::to_string(s->input_size));
         } else {
-            g_input_size = 640;
-            DebugLog("EnsureSession: using default input size 640");
+            s->dynamic_input = shape.size() == 4;
+            s->input_size = (s->dynamic_input && input_size > 0) ? input_size : kDefaultInputSize;
+            DebugLog("EnsureSession: using input size " + std::to_string(s->input_size) +
+                     std::string(s->dynamic_input ? " (dynamic H/W)" : ""));
+        }
+        s->dynamic_batch = shape.size() == 4 && shape[0] <= 0;
+        DebugLog(std::string("EnsureSession: batch axis is ") + (s->dynamic_batch ? "dynamic" : "fixed"));
+
+        s->half_input  = tensor_info.GetElementType() == ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16;
+        s->half_output = s->session->GetOutputTypeInfo(0).GetTensorTypeAndShapeInfo().GetElementType() ==
+                         ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16;
+        if (s->half_input || s->half_output) {
+            DebugLog(std::string("EnsureSession: FP16 model (input ") + (s->half_input ? "half" : "float") +
+                     ", output " + (s->half_output ? "half" : "float") + ")");
         }
 
         // Cache input/output names to avoid per-call ORT allocation
         {
             Ort::AllocatorWithDefaultOptions alloc;
-            g_input_name  = g_session->GetInputNameAllocated(0, alloc).get();
-            g_output_name = g_session->GetOutputNameAllocated(0, alloc).get();
+            s->input_name  = s->session->GetInputNameAllocated(0, alloc).get();
+            s->output_name = s->session->GetOutputNameAllocated(0, alloc).get();
         }
 
-        // Pre-allocate inference input buffer
-        g_input_buffer.assign(static_cast<size_t>(3) * g_input_size * g_input_size, 0.0f);
+        // Pre-allocate inference input buffers
+        s->input_w = s->input_h = s->input_size;
+        s->input_buffer.assign(static_cast<size_t>(3) * s->input_size * s->input_size, 0.0f);
+        if (s->rgb8_input)
+            s->bound_input_rgb8.assign(s->input_buffer.size(), 0);
+        else if (s->half_input)
+            s->bound_input_half.assign(s->input_buffer.size(), Float16());
+        else
+            s->bound_input.assign(s->input_buffer.size(), 0.0f);
+        if (!gpu_ok) BindSessionBuffers(*s);
+        WarmUpSession(*s);
 
-        g_current_model_path = model_path_utf8;
-        g_current_use_gpu = use_gpu;
-        g_session_ready = true;
-        DebugLog("EnsureSession: model loaded successfully");
+        s->est_bytes = EstimateSessionBytes(*s);
+        DebugLog("EnsureSession: model loaded successfully (~" +
+                 std::to_string(s->est_bytes >> 20) + " MB)");
+        return s;
 
     } catch (const Ort::Exception& e) {
         DebugLog(std::string("EnsureSession failed: ") + e.what());
-        g_session.reset();
-        g_options.reset();
-        g_session_ready = false;
     } catch (const std::exception& e) {
         DebugLog(std::string("EnsureSession exception: ") + e.what());
-        g_session.reset();
-        g_options.reset();
-        g_session_ready = false;
     }
+    return nullptr;
+}
+
+// Drop least-recently-used sessions until the cache fits the budget. The
+// active session is always kept, even if it alone is over budget, as is the
+// front entry (the one just loaded). Caller holds the mutex.
+static void EvictOverBudget() {
+    size_t total = 0;
+    for (const auto& s : g_sessions) total += s->est_bytes;
+    auto it = g_sessions.end();
+    while (total > g_cache_budget && it != g_sessions.begin()) {
+        --it;
+        if (it == g_sessions.begin() || it->get() == g_active.load()) continue;
+        DebugLog("EnsureSession: evicting " + (*it)->model_path +
+                 ((*it)->use_gpu ? " (GPU)" : " (CPU)"));
+        total -= (*it)->est_bytes;
+        it = g_sessions.erase(it);
+    }
+}
+
+// Cached entry for a request, or end(). Caller holds the mutex.
+static std::list<std::unique_ptr<CachedSession>>::iterator
+FindSession(const char* model_path_utf8, bool use_gpu, int input_size) {
+    for (auto it = g_sessions.begin(); it != g_sessions.end(); ++it) {
+        if (SessionMatches(**it, model_path_utf8, use_gpu, input_size)) return it;
+    }
+    return g_sessions.end();
+}
+
+// In-flight preload for exactly this request, or null. Caller holds the mutex.
+static PreloadTask* FindPreload(const char* model_path_utf8, bool use_gpu, int input_size) {
+    for (auto& task : g_preloads) {
+        if (task.model_path == model_path_utf8 && task.use_gpu == use_gpu &&
+            task.input_size == input_size &&
+            task.done.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return &task;
+        }
+    }
+    return nullptr;
+}
+
+// Join and drop preload threads that have finished. Caller holds the mutex;
+// finished workers no longer need it, so joining cannot deadlock.
+static void ReapPreloads() {
+    for (auto it = g_preloads.begin(); it != g_preloads.end();) {
+        if (it->done.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            it->thread.join();
+            it = g_preloads.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+static void PreloadWorker(std::string model_path, bool use_gpu, int input_size,
+                          std::promise<void> done) {
+    std::unique_ptr<CachedSession> loaded = LoadSession(model_path.c_str(), use_gpu, input_size);
+    if (loaded) {
+        std::lock_guard<std::mutex> lock(GetMutex());
+        if (g_initialized && FindSession(model_path.c_str(), use_gpu, input_size) == g_sessions.end()) {
+            g_sessions.push_front(std::move(loaded));
+            EvictOverBudget();
+            g_last_use = std::chrono::steady_clock::now();
+        }
+    }
+    loaded.reset();
+    done.set_value();
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+void YoloEngine::EnsureSession(const char* model_path_utf8, bool use_gpu, int input_size) {
+    std::unique_lock<std::mutex> lock(GetMutex());
+
+    std::call_once(g_init_flag, InitializeInternal);
+    if (!g_initialized) return;
+    g_last_use = std::chrono::steady_clock::now();
+
+    // A preload of this model is still running: wait for it rather than
+    // loading the same file twice. The lock is released so it can finish.
+    if (PreloadTask* task = FindPreload(model_path_utf8, use_gpu, input_size)) {
+        std::shared_future<void> done = task->done;
+        lock.unlock();
+        done.wait();
+        lock.lock();
+        if (!g_initialized) return;
+    }
+
+    // Cache hit: move to the front and make it active, no reload.
+    auto it = FindSession(model_path_utf8, use_gpu, input_size);
+    if (it != g_sessions.end()) {
+        if (it != g_sessions.begin())
+            g_sessions.splice(g_sessions.begin(), g_sessions, it);
+        g_active = g_sessions.front().get();
+        return;
+    }
+
+    AcquireSharedResources();
+    std::unique_ptr<CachedSession> loaded = LoadSession(model_path_utf8, use_gpu, input_size);
+    if (!loaded) {
+        g_active = nullptr;
+        return;
+    }
+
+    g_sessions.push_front(std::move(loaded));
+    g_active = g_sessions.front().get();
+    EvictOverBudget();
+}
+
+void YoloEngine::PreloadSession(const char* model_path_utf8, bool use_gpu, int input_size) {
+    if (!model_path_utf8 || !*model_path_utf8) return;
+    std::lock_guard<std::mutex> lock(GetMutex());
+
+    std::call_once(g_init_flag, InitializeInternal);
+    if (!g_initialized) return;
+
+    ReapPreloads();
+    if (FindSession(model_path_utf8, use_gpu, input_size) != g_sessions.end() ||
+        FindPreload(model_path_utf8, use_gpu, input_size)) {
+        return;
+    }
+
+    DebugLog(std::string("PreloadSession: loading in background: ") + model_path_utf8);
+    AcquireSharedResources();
+    g_last_use = std::chrono::steady_clock::now();
+    std::promise<void> done;
+    PreloadTask& task = g_preloads.emplace_back();
+    task.model_path = model_path_utf8;
+    task.use_gpu    = use_gpu;
+    task.input_size = input_size;
+    task.done       = done.get_future().share();
+    task.thread     = std::thread(PreloadWorker, task.model_path, use_gpu, input_size, std::move(done));
+}
+
+bool YoloEngine::TunePending() {
+    std::lock_guard<std::mutex> lock(g_tune_mutex);
+    return !g_tune_queue.empty();
+}
+
+bool YoloEngine::RunPendingTune(const std::function<bool(int, int)>& progress) {
+    // Background loads would share the cores with the benchmark.
+    std::vector<std::shared_future<void>> loading;
+    {
+        std::lock_guard<std::mutex> lock(GetMutex());
+        if (!g_initialized) return false;
+        for (auto& task : g_preloads) loading.push_back(task.done);
+    }
+    for (auto& done : loading) {
+        while (done.wait_for(std::chrono::milliseconds(100)) != std::future_status::ready) {
+            if (!progress(0, 1)) return false;
+        }
+    }
+
+    bool saved = false;
+    for (;;) {
+        TuneRequest request;
+        {
+            std::lock_guard<std::mutex> lock(g_tune_mutex);
+            if (g_tune_queue.empty()) break;
+            request = g_tune_queue.front();
+            g_tune_queue.pop_front();
+        }
+        bool cancelled = false;
+        auto report = [&](int step, int steps) {
+            cancelled = cancelled || !progress(step, steps);
+            return !cancelled;
+        };
+        DebugLog("AutoTune: tuning " + request.model_file.u8string());
+        TuneProfile::Profile profile = TuneModel(request.model_file, request.quantized, request.try_gpu,
+                                                 request.input_size > 0 ? request.input_size : kDefaultInputSize,
+                                                 report);
+        if (cancelled) {
+            DebugLog("AutoTune: cancelled, will tune at the next Analyze");
+            std::lock_guard<std::mutex> lock(g_tune_mutex);
+            g_tune_queue.push_front(std::move(request));
+            break;
+        }
+        if (profile.fps > 0.0 && TuneProfile::Save(request.profile_file, profile)) {
+            DebugLog("AutoTune: saved profile " + request.profile_file.u8string() +
+                     " (applies from the next load)");
+            saved = true;
+        }
+    }
+    return saved;
+}
+
+bool YoloEngine::IsQuantizedModel(const char* model_path_utf8) {
+    return model_path_utf8 && IsQuantizedModelFile(fs::u8path(model_path_utf8));
 }
 
 bool YoloEngine::IsReady() {
-    return g_session_ready;
+    return g_active.load() != nullptr;
+}
+
+std::string YoloEngine::ActiveModelPath() {
+    CachedSession* s = g_active.load();
+    return s ? s->model_path : std::string();
 }
 
 int YoloEngine::GetInputSize() {
-    return g_session_ready ? g_input_size : 0;
+    CachedSession* s = g_active.load();
+    return s ? s->input_size : 0;
 }
 
-bool YoloEngine::RunInference(const float* input_chw,
-                               std::vector<float>& raw_output,
-                               std::vector<int64_t>& out_shape) {
-    if (!g_session_ready || !g_session) return false;
+bool YoloEngine::HasDynamicInputSize() {
+    CachedSession* s = g_active.load();
+    return s && s->dynamic_input;
+}
+
+bool YoloEngine::SetInputShape(int width, int height) {
+    CachedSession* active = g_active.load();
+    if (!active || width <= 0 || height <= 0) return false;
+    CachedSession& s = *active;
+    if (width == s.input_w && height == s.input_h) return true;
+    if (!s.dynamic_input) return width == s.input_size && height == s.input_size;
 
+    s.input_w = width;
+    s.input_h = height;
+    // Shrinking keeps the allocation, so the square buffer from load time
+    // serves every smaller shape; rebinding picks up the new dims.
+    size_t tensor_size = static_cast<size_t>(3) * width * height;
+    if (s.rgb8_input)      s.bound_input_rgb8.resize(tensor_size);
+    else if (s.half_input) s.bound_input_half.resize(tensor_size);
+    else                   s.bound_input.resize(tensor_size);
+    if (s.binding) BindSessionBuffers(s);
+
+    auto shape = std::make_pair(width, height);
+    if (std::find(s.warmed_shapes.begin(), s.warmed_shapes.end(), shape) == s.warmed_shapes.end())
+        WarmUpSession(s);
+    return true;
+}
+
+int YoloEngine::GetInputWidth() {
+    CachedSession* s = g_active.load();
+    return s ? s->input_w : 0;
+}
+
+int YoloEngine::GetInputHeight() {
+    CachedSession* s = g_active.load();
+    return s ? s->input_h : 0;
+}
+
+int YoloEngine::ParallelSessionCount() {
+    CachedSession* s = g_active.load();
+    return s ? 1 + static_cast<int>(s->replicas.size()) : 0;
+}
+
+bool YoloEngine::HasDynamicBatch() {
+    CachedSession* s = g_active.load();
+    return s && s->dynamic_batch;
+}
+
+int YoloEngine::PreferredBatchSize() {
+    CachedSession* s = g_active.load();
+    if (!s) return 1;
+    if (s->cpu.batch > 0) return s->cpu.batch;
+    if (!s->replicas.empty()) return 1 + static_cast<int>(s->replicas.size());
+    return s->dynamic_batch ? 4 : 1;
+}
+
+// Run the active session on its input_buffer as a [batch, 3, height, width]
+// tensor. FP16 / uint8 models get it converted; FP16 outputs come back widened.
+static bool RunInputBuffer(int batch, int width, int height,
+                           std::vector<float>& raw_output,
+                           std::vector<int64_t>& out_shape,
+                           const Ort::RunOptions& run_options = AnalysisRunOptions()) {
+    CachedSession& s = *g_active.load();
     try {
         static Ort::MemoryInfo mem_info =
             Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPUInput);
 
-        size_t tensor_size = static_cast<size_t>(3) * g_input_size * g_input_size;
-        std::vector<int64_t> input_shape = {1, 3, g_input_size, g_input_size};
-
-        // Copy input to a dedicated buffer so DirectML/CoreML sees a fresh
-        // allocation each call and doesn't serve a stale GPU-side cache.
-        g_input_buffer.assign(input_chw, input_chw + tensor_size);
+        std::vector<int64_t> input_shape = {batch, 3, height, width};
 
-        Ort::Value input_tensor = Ort::Value::CreateTensor<float>(
-            mem_info,
-            g_input_buffer.data(),
-            tensor_size,
+        Ort::Value input_tensor = CopyInputTensor(
+            s, mem_info,
+            s.input_buffer.data(),
+            s.input_buffer.size(),
+            s.input_converted,
             input_shape.data(),
             input_shape.size());
 
-        const char* input_names[]  = { g_input_name.c_str() };
-        const char* output_names[] = { g_output_name.c_str() };
+        const char* input_names[]  = { s.input_name.c_str() };
+        const char* output_names[] = { s.output_name.c_str() };
 
-        auto outputs = g_session->Run(
-            Ort::RunOptions{nullptr},
+        auto outputs = s.session->Run(
+            run_options,
             input_names, &input_tensor, 1,
             output_names, 1);
 
-        // Get output tensor info
-        auto type_info = outputs[0].GetTensorTypeAndShapeInfo();
-        out_shape = type_info.GetShape();
-        size_t out_count = type_info.GetElementCount();
-
-        const float* out_data = outputs[0].GetTensorData<float>();
-        raw_output.assign(out_data, out_data + out_count);
-
+        CopyOutput(outputs[0], raw_output, out_shape);
         return true;
     } catch (const Ort::Exception& e) {
-        DebugLog(std::string("RunInference failed: ") + e.what());
+        LogRunError("RunInference", e);
         return false;
     } catch (...) {
         DebugLog("RunInference: unknown exception");
@@ -343,12 +1655,322 @@ bool YoloEngine::RunInference(const float* input_chw,
     }
 }
 
+bool YoloEngine::RunInference(const float* input_chw,
+                               std::vector<float>& raw_output,
+                               std::vector<int64_t>& out_shape) {
+    return RunInference(input_chw, 0, raw_output, out_shape);
+}
+
+bool YoloEngine::RunInference(const float* input_chw,
+                               int input_size,
+                               std::vector<float>& raw_output,
+                               std::vector<int64_t>& out_shape) {
+    CachedSession* active = g_active.load();
+    if (!active) return false;
+    CachedSession& s = *active;
+
+    // input_size > 0 asks for a square input; fixed-shape models only accept
+    // their own size. Otherwise run at the current (possibly rectangular) shape.
+    int width = s.input_w, height = s.input_h;
+    if (input_size > 0) {
+        if (!s.dynamic_input && input_size != s.input_size) {
+            DebugLog("RunInference: model has fixed input size " + std::to_string(s.input_size) +
+                     ", cannot run at " + std::to_string(input_size));
+            return false;
+        }
+        width = height = input_size;
+    }
+
+    // Copy input to a dedicated buffer so DirectML/CoreML sees a fresh
+    // allocation each call and doesn't serve a stale GPU-side cache.
+    size_t tensor_size = static_cast<size_t>(3) * width * height;
+
+    // Square tracking crops on dynamic models come in any multiple of 32 and
+    // never pass through SetInputShape, so warm each new one up here.
+    auto shape = std::make_pair(width, height);
+    if (std::find(s.warmed_shapes.begin(), s.warmed_shapes.end(), shape) == s.warmed_shapes.end()) {
+        s.input_buffer.assign(tensor_size, 114.0f / 255.0f);
+        std::vector<float> warm_output;
+        std::vector<int64_t> warm_shape;
+        if (RunInputBuffer(1, width, height, warm_output, warm_shape, Ort::RunOptions{nullptr}))
+            DebugLog("RunInference: warm-up inference done (" + std::to_string(width) +
+                     "x" + std::to_string(height) + ")");
+        s.warmed_shapes.push_back(shape);
+    }
+
+    s.input_buffer.assign(input_chw, input_chw + tensor_size);
+
+    return RunInputBuffer(1, width, height, raw_output, out_shape);
+}
+
+// Run n images on the session and its replicas at once. Each session takes
+// the next unclaimed image from a shared queue until none are left; outputs
+// are stacked in input order. Inputs are CPU-only here, so they are wrapped
+// in place rather than copied (FP16 / uint8 models convert them per worker).
+static bool RunOnReplicas(CachedSession& s, const float* const* inputs, int n,
+                          std::vector<float>& raw_output,
+                          std::vector<int64_t>& out_shape) {
+    std::vector<Ort::Session*> sessions = { s.session.get() };
+    for (auto& r : s.replicas) sessions.push_back(r.get());
+    const int workers = std::min(static_cast<int>(sessions.size()), n);
+
+    const size_t tensor_size = static_cast<size_t>(3) * s.input_w * s.input_h;
+    const int64_t input_shape[] = { 1, 3, s.input_h, s.input_w };
+    std::vector<std::vector<float>> outputs(n);
+    std::vector<std::vector<int64_t>> shapes(n);
+    std::atomic<int> next{0};
+    std::atomic<bool> ok{true};
+
+    ThreadPool::Shared().ParallelFor(workers, workers, [&](int begin, int end) {
+        static Ort::MemoryInfo mem_info =
+            Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPUInput);
+        const char* input_names[]  = { s.input_name.c_str() };
+        const char* output_names[] = { s.output_name.c_str() };
+        ConvertedInput converted;   // this worker's input for FP16 / uint8 models
+        for (int w = begin; w < end; w++) {
+            int i;
+            while (ok && (i = next.fetch_add(1)) < n) {
+                try {
+                    Ort::Value input_tensor = CopyInputTensor(
+                        s, mem_info, inputs[i], tensor_size, converted, input_shape, 4);
+                    auto result = sessions[w]->Run(AnalysisRunOptions(),
+                                                   input_names, &input_tensor, 1,
+                                                   output_names, 1);
+                    CopyOutput(result[0], outputs[i], shapes[i]);
+                } catch (const Ort::Exception& e) {
+                    LogRunError("RunInferenceBatch", e);
+                    ok = false;
+                }
+            }
+        }
+    });
+    if (!ok) return false;
+
+    raw_output.clear();
+    raw_output.reserve(outputs[0].size() * n);
+    for (const auto& o : outputs) raw_output.insert(raw_output.end(), o.begin(), o.end());
+    out_shape = shapes[0];
+    if (!out_shape.empty()) out_shape[0] = n;
+    return true;
+}
+
+bool YoloEngine::RunInferenceBatch(const float* const* inputs, int n,
+                                   std::vector<float>& raw_output,
+                                   std::vector<int64_t>& out_shape) {
+    CachedSession* active = g_active.load();
+    if (!active || n <= 0) return false;
+    CachedSession& s = *active;
+
+    if (n > 1 && !s.replicas.empty())
+        return RunOnReplicas(s, inputs, n, raw_output, out_shape);
+
+    if (n == 1 || !s.dynamic_batch) {
+        // Fixed batch of 1: run each image and stack the outputs along axis 0.
+        std::vector<float> single;
+        std::vector<int64_t> single_shape;
+        raw_output.clear();
+        for (int i = 0; i < n; i++) {
+            if (!RunInference(inputs[i], single, single_shape)) return false;
+            if (i == 0) raw_output.reserve(single.size() * n);
+            raw_output.insert(raw_output.end(), single.begin(), single.end());
+        }
+        out_shape = single_shape;
+        if (!out_shape.empty()) out_shape[0] = n;
+        return true;
+    }
+
+    // One [N, 3, H, W] tensor: each image is copied into its batch slot.
+    size_t tensor_size = static_cast<size_t>(3) * s.input_w * s.input_h;
+    s.input_buffer.resize(tensor_size * n);
+    for (int i = 0; i < n; i++)
+        std::copy(inputs[i], inputs[i] + tensor_size, s.input_buffer.begin() + tensor_size * i);
+
+    return RunInputBuffer(n, s.input_w, s.input_h, raw_output, out_shape);
+}
+
+std::vector<float>& YoloEngine::InputBuffer() {
+    // Only meaningful while a session is ready; callers check IsReady() first.
+    static std::vector<float> empty;
+    CachedSession* s = g_active.load();
+    return s ? s->bound_input : empty;
+}
+
+bool YoloEngine::HasFloat16Input() {
+    CachedSession* s = g_active.load();
+    return s && s->half_input;
+}
+
+std::vector<Float16>& YoloEngine::InputBufferHalf() {
+    static std::vector<Float16> empty;
+    CachedSession* s = g_active.load();
+    return s ? s->bound_input_half : empty;
+}
+
+bool YoloEngine::HasRGB8Input() {
+    CachedSession* s = g_active.load();
+    return s && s->rgb8_input;
+}
+
+std::vector<unsigned char>& YoloEngine::InputBufferRGB8() {
+    static std::vector<unsigned char> empty;
+    CachedSession* s = g_active.load();
+    return s ? s->bound_input_rgb8 : empty;
+}
+
+void YoloEngine::RequestCancel() {
+    g_cancel_requested = true;
+    if (g_run_options) g_run_options->SetTerminate();
+    if (g_shrink_run_options) g_shrink_run_options->SetTerminate();
+    DebugLog("RequestCancel: terminating in-flight inference");
+}
+
+void YoloEngine::SetArenaShrinkage(bool enable) {
+    CachedSession* s = g_active.load();
+    g_shrink_runs = enable && g_env_arena && s && (s->gpu_ok || s->cpu.arena);
+}
+
+void YoloEngine::ReleaseArenaMemory() {
+    CachedSession* s = g_active.load();
+    if (!g_env_arena || !s || !(s->gpu_ok || s->cpu.arena)) return;
+    // Own options: the shared ones may still be terminated by a Cancel.
+    Ort::RunOptions release_options;
+    release_options.AddConfigEntry(kOrtRunOptionsConfigEnableMemoryArenaShrinkage, "cpu:0");
+    FillInputGray(*s);
+    TensorView output;
+    if (RunBound(*s, release_options, output))
+        DebugLog("ReleaseArenaMemory: arena shrunk");
+}
+
+void YoloEngine::PinSessions() {
+    std::lock_guard<std::mutex> lock(GetMutex());
+    g_pins++;
+}
+
+void YoloEngine::UnpinSessions() {
+    std::lock_guard<std::mutex> lock(GetMutex());
+    g_pins--;
+    g_last_use = std::chrono::steady_clock::now();
+}
+
+YoloEngine::SessionPin::SessionPin() { PinSessions(); }
+YoloEngine::SessionPin::~SessionPin() { UnpinSessions(); }
+
+void YoloEngine::ResetCancel() {
+    if (g_run_options) g_run_options->UnsetTerminate();
+    if (g_shrink_run_options) g_shrink_run_options->UnsetTerminate();
+    g_cancel_requested = false;
+}
+
+bool YoloEngine::RunInference(TensorView& output) {
+    CachedSession* s = g_active.load();
+    return s && RunBound(*s, AnalysisRunOptions(), output);
+}
+
+// ============================================================================
+// InferenceBackend
+// ============================================================================
+// This engine behind the InferenceBackend interface. It has no state of its
+// own: every call goes to the functions above and their globals.
+class OrtBackend : public InferenceBackend {
+public:
+    const char* Name() const override { return "onnxruntime"; }
+
+    void EnsureSession(const char* model_path_utf8, bool use_gpu, int input_size) override {
+        YoloEngine::EnsureSession(model_path_utf8, use_gpu, input_size);
+    }
+    void PreloadSession(const char* model_path_utf8, bool use_gpu, int input_size) override {
+        YoloEngine::PreloadSession(model_path_utf8, use_gpu, input_size);
+    }
+    bool IsReady() override { return YoloEngine::IsReady(); }
+    std::string ActiveModelPath() override { return YoloEngine::ActiveModelPath(); }
+
+    int  GetInputSize() override { return YoloEngine::GetInputSize(); }
+    bool HasDynamicInputSize() override { return YoloEngine::HasDynamicInputSize(); }
+    bool SetInputShape(int width, int height) override { return YoloEngine::SetInputShape(width, height); }
+    int  GetInputWidth() override { return YoloEngine::GetInputWidth(); }
+    int  GetInputHeight() override { return YoloEngine::GetInputHeight(); }
+    bool HasDynamicBatch() override { return YoloEngine::HasDynamicBatch(); }
+    int  ParallelSessionCount() override { return YoloEngine::ParallelSessionCount(); }
+    int  PreferredBatchSize() override { return YoloEngine::PreferredBatchSize(); }
+
+    bool HasFloat16Input() override { return YoloEngine::HasFloat16Input(); }
+    bool HasRGB8Input() override { return YoloEngine::HasRGB8Input(); }
+    std::vector<Float16>& InputBufferHalf() override { return YoloEngine::InputBufferHalf(); }
+    std::vector<unsigned char>& InputBufferRGB8() override { return YoloEngine::InputBufferRGB8(); }
+
+    std::vector<float>& InputBuffer() override { return YoloEngine::InputBuffer(); }
+    bool RunInference(TensorView& output) override { return YoloEngine::RunInference(output); }
+    bool RunInference(const float* input_chw, int input_size,
+                      std::vector<float>& raw_output, std::vector<int64_t>& out_shape) override {
+        return YoloEngine::RunInference(input_chw, input_size, raw_output, out_shape);
+    }
+    bool RunInferenceBatch(const float* const* inputs, int n,
+                           std::vector<float>& raw_output, std::vector<int64_t>& out_shape) override {
+        return YoloEngine::RunInferenceBatch(inputs, n, raw_output, out_shape);
+    }
+
+    void RequestCancel() override { YoloEngine::RequestCancel(); }
+    void ResetCancel() override { YoloEngine::ResetCancel(); }
+
+    void Pin() override { YoloEngine::PinSessions(); }
+    void Unpin() override { YoloEngine::UnpinSessions(); }
+    void SetArenaShrinkage(bool enable) override { YoloEngine::SetArenaShrinkage(enable); }
+    void ReleaseArenaMemory() override { YoloEngine::ReleaseArenaMemory(); }
+
+    bool TunePending() override { return YoloEngine::TunePending(); }
+    bool RunPendingTune(const std::function<bool(int, int)>& progress) override {
+        return YoloEngine::RunPendingTune(progress);
+    }
+};
+
+static std::unique_ptr<InferenceBackend> CreateBackend() {
+    const char* name = std::getenv("AE_YOLO_BACKEND");
+    if (name && std::string(name) == "stub") {
+        StubBackendOptions options;
+        options.format = GetEnvInt("AE_YOLO_STUB_POST_NMS", 0) > 0 ? StubOutputFormat::PostNms
+                                                                   : StubOutputFormat::RawAnchors;
+        options.image_latency_ms = std::max(0, GetEnvInt("AE_YOLO_STUB_LATENCY_MS", 0));
+        DebugLog(std::string("Backend: stub (") +
+                 (options.format == StubOutputFormat::PostNms ? "post-NMS" : "raw anchors") + ", " +
+                 std::to_string(static_cast<int>(options.image_latency_ms)) + " ms per frame)");
+        return std::make_unique<StubBackend>(options);
+    }
+    return std::make_unique<OrtBackend>();
+}
+
+InferenceBackend& YoloEngine::Backend() {
+    static std::unique_ptr<InferenceBackend> backend = CreateBackend();
+    return *backend;
+}
+
 void YoloEngine::Shutdown() {
+    // Stop the idle watcher before anything it could race with.
+    {
+        std::lock_guard<std::mutex> lock(GetMutex());
+        g_idle_stop = true;
+    }
+    g_idle_cv.notify_all();
+    if (g_idle_thread.joinable()) g_idle_thread.join();
+    {
+        std::lock_guard<std::mutex> lock(g_tune_mutex);
+        g_tune_queue.clear();
+    }
+
+    // Let background loads finish first; they need the mutex to insert.
+    std::list<PreloadTask> preloads;
+    {
+        std::lock_guard<std::mutex> lock(GetMutex());
+        preloads.swap(g_preloads);
+    }
+    for (auto& task : preloads) task.thread.join();
+
     std::lock_guard<std::mutex> lock(GetMutex());
-    g_session.reset();
-    g_options.reset();
+    g_active = nullptr;
+    g_sessions.clear();
+    ReleaseSharedResources();
+    g_shrink_run_options.reset();
+    g_run_options.reset();
     g_env.reset();
-    g_session_ready = false;
     g_initialized = false;
     DebugLog("Shutdown: ONNX Runtime resources released");
 }
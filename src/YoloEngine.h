@@ -1,12 +1,51 @@
 #pragma once
 
 #include <vector>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "InferenceBackend.h"
+#include "TensorView.h"
 
 namespace YoloEngine {
 
-    // Ensure a session is loaded for the given model path + GPU preference.
-    // Thread-safe. If the model is already loaded, does nothing.
-    void EnsureSession(const char* model_path_utf8, bool use_gpu);
+    // The backend the plugin and FrameAnalyzer run on, chosen once per
+    // process: this engine behind the InferenceBackend interface, or a
+    // StubBackend when AE_YOLO_BACKEND=stub (no model file or ONNX Runtime
+    // session needed; AE_YOLO_STUB_POST_NMS and AE_YOLO_STUB_LATENCY_MS pick
+    // its output format and simulated time per frame). The functions below
+    // always address this engine.
+    InferenceBackend& Backend();
+
+    // Make the session for (model path, GPU preference, input size) active,
+    // loading it if needed. Thread-safe. Loaded sessions stay resident in an
+    // LRU cache (budget: AE_YOLO_SESSION_CACHE_MB, default 2048), so switching
+    // back to a cached model or EP does not reload it. input_size only applies
+    // to dynamic H/W models (0 = 640); fixed-shape models use their own size.
+    void EnsureSession(const char* model_path_utf8, bool use_gpu, int input_size = 0);
+
+    // Start loading a session on a background thread and warm it up with one
+    // dummy inference, without changing the active session. No-op if it is
+    // already cached or loading. A later EnsureSession for the same model waits
+    // for this load instead of starting another.
+    void PreloadSession(const char* model_path_utf8, bool use_gpu, int input_size = 0);
+
+    // Auto-tuning (AE_YOLO_AUTOTUNE=1): a load that finds no tuned profile
+    // queues a tune instead of benchmarking on its own. TunePending() tells
+    // whether one is queued; RunPendingTune runs the queue on this thread
+    // (after waiting for running preloads), saving each profile for the
+    // model's next load. progress(step, steps) is called between
+    // configurations and timed rounds; returning false cancels, leaving the
+    // tune queued. Call with the sessions pinned. True if a profile was saved.
+    bool TunePending();
+    bool RunPendingTune(const std::function<bool(int step, int steps)>& progress);
+
+    // True for INT8 (QDQ or QOperator) models, recognized by "int8" in the
+    // file name (e.g. yolo26x-pose-int8.onnx, as written by
+    // tools/quantize_int8.py). Their sessions always run on the CPU EP with
+    // ORT's integer kernels enabled.
+    bool IsQuantizedModel(const char* model_path_utf8);
 
     // Check if a model is currently loaded and ready for inference.
     bool IsReady();
@@ -14,8 +53,49 @@ namespace YoloEngine {
     // Get model input size (e.g. 640). Returns 0 if not ready.
     int GetInputSize();
 
-    // Run inference on a single preprocessed image.
-    // input_chw: [3 * input_size * input_size] float32, values in [0,1], CHW layout
+    // True if the loaded model declares symbolic H/W, so RunInference can be
+    // called with a smaller square input (a multiple of 32).
+    bool HasDynamicInputSize();
+
+    // Set the width x height that InputBuffer, RunInference(output) and
+    // RunInferenceBatch use, e.g. 640x384 for a 16:9 frame (see
+    // LetterboxInputShape). Dynamic H/W models only; a fixed-shape model
+    // accepts just its own square. The first run at each new shape is a
+    // warm-up done here, so analysis frames never pay for it.
+    bool SetInputShape(int width, int height);
+
+    // Current input width / height (both GetInputSize() unless SetInputShape
+    // chose a rectangle). Return 0 if not ready.
+    int GetInputWidth();
+    int GetInputHeight();
+
+    // Zero-copy single-image path: letterbox straight into InputBuffer()
+    // ([3 * height * width] floats — do not resize it), then call
+    // RunInference(output). On the CPU EP the buffers are bound to the session
+    // once, so steady-state calls neither allocate nor copy. The output view
+    // stays valid until the next inference call or session change; for FP16
+    // models it is a half tensor (output.type), read as is by YoloPostprocess.
+    std::vector<float>& InputBuffer();
+    bool RunInference(TensorView& output);
+
+    // True if the loaded model takes a float16 input. The zero-copy path then
+    // uses InputBufferHalf() (same size and rules) instead of InputBuffer(),
+    // which stays empty. The copying paths below still take float input and
+    // return float output; they convert for FP16 models.
+    bool HasFloat16Input();
+    std::vector<Float16>& InputBufferHalf();
+
+    // True if the loaded model takes uint8 [1, H, W, 3] RGB with the /255
+    // and the transpose inside the graph (tools/fold_uint8_input.py). The
+    // zero-copy path then uses InputBufferRGB8() ([height * width * 3] bytes,
+    // filled by LetterboxPreprocessRGB8). The copying paths still take float
+    // CHW and are converted.
+    bool HasRGB8Input();
+    std::vector<unsigned char>& InputBufferRGB8();
+
+    // Run inference on a single preprocessed image (copies input and output).
+    // input_chw: [3 * height * width] float32 at the current input shape,
+    //            values in [0,1], CHW layout
     // raw_output: receives the raw model output tensor (flattened)
     // out_shape: receives the output tensor shape
     // Returns true on success.
@@ -23,6 +103,75 @@ namespace YoloEngine {
                       std::vector<float>& raw_output,
                       std::vector<int64_t>& out_shape);
 
-    // Cleanup all ONNX Runtime resources.
+    // Same, at an explicit square input size (dynamic-shape models only;
+    // 0 = the model's input size).
+    bool RunInference(const float* input_chw,
+                      int input_size,
+                      std::vector<float>& raw_output,
+                      std::vector<int64_t>& out_shape);
+
+    // True if the loaded model declares a symbolic batch axis, so
+    // RunInferenceBatch runs all images in one [N, 3, H, W] call.
+    bool HasDynamicBatch();
+
+    // Number of CPU sessions RunInferenceBatch runs frames on concurrently
+    // (AE_YOLO_CPU_SESSIONS or the tuned profile; 1 by default, and always 1
+    // on GPU EPs).
+    int ParallelSessionCount();
+
+    // Frames to pass to each RunInferenceBatch call: the tuned profile's
+    // batch, else one per parallel session, 4 on dynamic-batch models, or 1.
+    int PreferredBatchSize();
+
+    // Run inference on n preprocessed images (each [3 * height * width] at the
+    // current input shape).
+    // With parallel CPU sessions the images are spread across them; otherwise
+    // it uses one batched Session::Run on dynamic-batch models and loops over
+    // single runs on fixed-batch ones. Either way raw_output holds the outputs
+    // stacked along axis 0 in input order and out_shape[0] == n. Slice with
+    // YoloPostprocessSlice.
+    bool RunInferenceBatch(const float* const* inputs, int n,
+                           std::vector<float>& raw_output,
+                           std::vector<int64_t>& out_shape);
+
+    // Abort inference in flight on any thread: the running Session::Run calls
+    // return early (the inference call reports failure) and later calls fail
+    // at once until ResetCancel(). Safe to call from any thread, e.g. a UI
+    // poll while another thread waits in RunInference.
+    void RequestCancel();
+
+    // Allow inference again after RequestCancel. Call before starting new work.
+    void ResetCancel();
+
+    // While enabled, each inference call also returns the free part of the
+    // shared CPU arena to the OS when it finishes. Enable it for the last
+    // inference of an analysis pass, so the pass's high-water mark is not kept
+    // afterwards, and disable it after.
+    void SetArenaShrinkage(bool enable);
+
+    // Return the shared CPU arena's free part to the OS now, with one
+    // uncancellable shrinking run on a gray frame. For a pass that ended
+    // without its shrinking last inference, e.g. one cancelled midway.
+    void ReleaseArenaMemory();
+
+    // Keep the loaded sessions from being unloaded as idle
+    // (AE_YOLO_IDLE_UNLOAD_MIN) until the matching UnpinSessions(). Pins
+    // nest; each unpin restarts the idle clock.
+    void PinSessions();
+    void UnpinSessions();
+
+    // Pins the sessions while alive. Hold one across any sequence of calls
+    // that uses the active session, e.g. a whole Analyze pass.
+    struct SessionPin {
+        SessionPin();
+        ~SessionPin();
+        SessionPin(const SessionPin&) = delete;
+        SessionPin& operator=(const SessionPin&) = delete;
+    };
+
+    // Path of the active session's model (empty if none).
+    std::string ActiveModelPath();
+
+    // Cleanup all ONNX Runtime resources, including every cached session.
     void Shutdown();
 }
@@ -76,17 +76,18 @@ static std::vector<int> NMS(const std::vector<Detection>& dets, float iou_thresh
 // Parse YOLO26/v11+ format: [1, N, 57] — already NMS'd
 // Layout: [x1, y1, x2, y2, conf, class_id, kp0_x, kp0_y, kp0_conf, ...]
 // ============================================================================
+template <typename T>
 static bool ParsePostNMS(
-    const float* data, int num_dets, int num_cols,
+    const T* data, int num_dets, int num_cols,
     const LetterboxInfo& info, float conf_threshold,
-    KeypointResult& result)
+    KeypointResult& result, DetectionBox* box)
 {
     float best_conf = -1.0f;
     int best_idx = -1;
 
     for (int i = 0; i < num_dets; i++) {
-        const float* row = data + i * num_cols;
-        float conf = row[4];
+        const T* row = data + i * num_cols;
+        float conf = ToFloat(row[4]);
         if (conf >= conf_threshold && conf > best_conf) {
             best_conf = conf;
             best_idx = i;
@@ -95,14 +96,20 @@ static bool ParsePostNMS(
 
     if (best_idx < 0) return false;
 
-    const float* row = data + best_idx * num_cols;
+    const T* row = data + best_idx * num_cols;
+
+    if (box) {
+        LetterboxRemap(info, ToFloat(row[0]), ToFloat(row[1]), box->x1, box->y1);
+        LetterboxRemap(info, ToFloat(row[2]), ToFloat(row[3]), box->x2, box->y2);
+        box->confidence = ToFloat(row[4]);
+    }
 
     // Keypoints start at index 6 (after x1, y1, x2, y2, conf, class_id)
     for (int k = 0; k < NUM_KEYPOINTS; k++) {
         int base = 6 + k * 3;
-        float kp_x = row[base];
-        float kp_y = row[base + 1];
-        float kp_conf = row[base + 2];
+        float kp_x = ToFloat(row[base]);
+        float kp_y = ToFloat(row[base + 1]);
+        float kp_conf = ToFloat(row[base + 2]);
 
         LetterboxRemap(info, kp_x, kp_y, result.x[k], result.y[k]);
         result.conf[k] = kp_conf;
@@ -116,30 +123,31 @@ static bool ParsePostNMS(
 // Layout per anchor column: [cx, cy, w, h, conf, kp0_x, kp0_y, kp0_conf, ...]
 // Data is in [features, anchors] layout: data[feature * num_anchors + anchor]
 // ============================================================================
+template <typename T>
 static bool ParseRawAnchors(
-    const float* data, int num_features, int num_anchors,
+    const T* data, int num_features, int num_anchors,
     const LetterboxInfo& info, float conf_threshold,
-    KeypointResult& result)
+    KeypointResult& result, DetectionBox* box)
 {
     std::vector<Detection> dets;
     dets.reserve(100);
 
     for (int a = 0; a < num_anchors; a++) {
-        float conf = data[4 * num_anchors + a]; // confidence at row 4
+        float conf = ToFloat(data[4 * num_anchors + a]); // confidence at row 4
         if (conf < conf_threshold) continue;
 
         Detection det;
-        det.cx = data[0 * num_anchors + a];
-        det.cy = data[1 * num_anchors + a];
-        det.w  = data[2 * num_anchors + a];
-        det.h  = data[3 * num_anchors + a];
+        det.cx = ToFloat(data[0 * num_anchors + a]);
+        det.cy = ToFloat(data[1 * num_anchors + a]);
+        det.w  = ToFloat(data[2 * num_anchors + a]);
+        det.h  = ToFloat(data[3 * num_anchors + a]);
         det.confidence = conf;
 
         for (int k = 0; k < NUM_KEYPOINTS; k++) {
             int base = 5 + k * 3; // 5 = 4 bbox + 1 conf
-            det.kp_x[k]    = data[base * num_anchors + a];
-            det.kp_y[k]    = data[(base + 1) * num_anchors + a];
-            det.kp_conf[k] = data[(base + 2) * num_anchors + a];
+            det.kp_x[k]    = ToFloat(data[base * num_anchors + a]);
+            det.kp_y[k]    = ToFloat(data[(base + 1) * num_anchors + a]);
+            det.kp_conf[k] = ToFloat(data[(base + 2) * num_anchors + a]);
         }
 
         dets.push_back(det);
@@ -154,6 +162,12 @@ static bool ParseRawAnchors(
     // Take highest-confidence detection
     const Detection& best = dets[keep[0]];
 
+    if (box) {
+        LetterboxRemap(info, best.cx - best.w / 2, best.cy - best.h / 2, box->x1, box->y1);
+        LetterboxRemap(info, best.cx + best.w / 2, best.cy + best.h / 2, box->x2, box->y2);
+        box->confidence = best.confidence;
+    }
+
     // Remap keypoints from model space to original image space
     for (int k = 0; k < NUM_KEYPOINTS; k++) {
         LetterboxRemap(info, best.kp_x[k], best.kp_y[k],
@@ -167,37 +181,18 @@ static bool ParseRawAnchors(
 // ============================================================================
 // Main entry point — auto-detects format
 // ============================================================================
-bool YoloPostprocess(
-    const std::vector<float>& raw_output,
-    const std::vector<int64_t>& out_shape,
+// `data` points at one image's output; dim1/dim2 are its two feature axes.
+// FP16 outputs are decoded in place, widening only the values read.
+template <typename T>
+static bool PostprocessImage(
+    const T* data, int64_t dim1, int64_t dim2,
     const LetterboxInfo& info,
     float conf_threshold,
-    KeypointResult& result)
+    KeypointResult& result,
+    DetectionBox* box)
 {
-    memset(&result, 0, sizeof(result));
-
-    if (out_shape.size() < 2) {
-        DebugLog("YoloPostprocess: unexpected shape dimension count: " +
-                 std::to_string(out_shape.size()));
-        return false;
-    }
-
-    // Determine format from shape
-    // YOLO26+:  [1, N, 57]  where N <= ~300, last dim = 57
-    // YOLOv8:   [1, 56, M]  where M >= 1000 (e.g. 8400), second dim = 56
-    int ndim = static_cast<int>(out_shape.size());
-    int64_t dim1 = out_shape[ndim >= 3 ? 1 : 0];
-    int64_t dim2 = out_shape[ndim >= 3 ? 2 : 1];
-
     // Log format detection once
     static bool s_logged_format = false;
-    if (!s_logged_format) {
-        DebugLog("YoloPostprocess: shape=[" +
-                 (ndim >= 3 ? std::to_string(out_shape[0]) + "," : "") +
-                 std::to_string(dim1) + "," + std::to_string(dim2) + "]");
-    }
-
-    const float* data = raw_output.data();
 
     // Heuristic: if last dim is 57 and second dim is small, it's post-NMS format
     if (dim2 == 57 || (dim2 >= 56 && dim2 <= 60 && dim1 <= 1000)) {
@@ -206,7 +201,7 @@ bool YoloPostprocess(
             s_logged_format = true;
         }
         return ParsePostNMS(data, static_cast<int>(dim1), static_cast<int>(dim2),
-                            info, conf_threshold, result);
+                            info, conf_threshold, result, box);
     }
     // If second dim is 56 and last dim is large, it's raw anchor format
     else if (dim1 == 56 || (dim1 >= 50 && dim1 <= 60 && dim2 >= 1000)) {
@@ -215,7 +210,7 @@ bool YoloPostprocess(
             s_logged_format = true;
         }
         return ParseRawAnchors(data, static_cast<int>(dim1), static_cast<int>(dim2),
-                               info, conf_threshold, result);
+                               info, conf_threshold, result, box);
     }
     else {
         DebugLog("YoloPostprocess: unrecognized output shape — dim1=" +
@@ -223,3 +218,70 @@ bool YoloPostprocess(
         return false;
     }
 }
+
+bool YoloPostprocess(
+    const TensorView& output,
+    const LetterboxInfo& info,
+    float conf_threshold,
+    KeypointResult& result,
+    DetectionBox* box)
+{
+    memset(&result, 0, sizeof(result));
+    if (box) memset(box, 0, sizeof(*box));
+
+    if (!output.data || output.rank < 2) {
+        DebugLog("YoloPostprocess: unexpected shape dimension count: " +
+                 std::to_string(output.rank));
+        return false;
+    }
+
+    // Determine format from shape
+    // YOLO26+:  [1, N, 57]  where N <= ~300, last dim = 57
+    // YOLOv8:   [1, 56, M]  where M >= 1000 (e.g. 8400), second dim = 56
+    int ndim = output.rank;
+    int64_t dim1 = output.shape[ndim >= 3 ? 1 : 0];
+    int64_t dim2 = output.shape[ndim >= 3 ? 2 : 1];
+
+    static bool s_logged_shape = false;
+    if (!s_logged_shape) {
+        DebugLog("YoloPostprocess: shape=[" +
+                 (ndim >= 3 ? std::to_string(output.shape[0]) + "," : "") +
+                 std::to_string(dim1) + "," + std::to_string(dim2) + "]");
+        s_logged_shape = true;
+    }
+
+    if (output.type == TensorElement::Float16)
+        return PostprocessImage(output.As<Float16>(), dim1, dim2, info, conf_threshold, result, box);
+    return PostprocessImage(output.As<float>(), dim1, dim2, info, conf_threshold, result, box);
+}
+
+bool YoloPostprocessSlice(
+    const TensorView& output,
+    int slice,
+    const LetterboxInfo& info,
+    float conf_threshold,
+    KeypointResult& result,
+    DetectionBox* box)
+{
+    memset(&result, 0, sizeof(result));
+    if (box) memset(box, 0, sizeof(*box));
+
+    if (!output.data || output.rank != 3 || slice < 0 || slice >= output.shape[0]) {
+        DebugLog("YoloPostprocessSlice: slice " + std::to_string(slice) +
+                 " out of range for shape rank " + std::to_string(output.rank));
+        return false;
+    }
+
+    size_t slice_size = static_cast<size_t>(output.shape[1]) * static_cast<size_t>(output.shape[2]);
+    if (output.Count() < slice_size * (slice + 1)) {
+        DebugLog("YoloPostprocessSlice: output too small for slice " + std::to_string(slice));
+        return false;
+    }
+
+    size_t offset = slice_size * slice;
+    if (output.type == TensorElement::Float16)
+        return PostprocessImage(output.As<Float16>() + offset, output.shape[1], output.shape[2],
+                                info, conf_threshold, result, box);
+    return PostprocessImage(output.As<float>() + offset, output.shape[1], output.shape[2],
+                            info, conf_threshold, result, box);
+}
@@ -2,18 +2,36 @@
 
 #include "AE_YOLO.h"
 #include "Letterbox.h"
+#include "TensorView.h"
 #include <vector>
 
+// Bounding box of the selected person, in original image pixel coordinates.
+struct DetectionBox {
+    float x1, y1, x2, y2;
+    float confidence;
+};
+
 // Process raw YOLO pose output into keypoints for a single frame.
-// raw_output: flattened output tensor from the model
-// out_shape: tensor shape (e.g. [1, 56, 8400])
+// output: view of the model's output tensor (e.g. shape [1, 56, 8400]); read
+//         in place, not copied
 // info: letterbox info for coordinate remapping
 // conf_threshold: minimum detection confidence
 // result: output keypoints in original image pixel coordinates
+// box: optional, receives the selected detection's box (used for tracking)
 // Returns true if a valid person detection was found.
 bool YoloPostprocess(
-    const std::vector<float>& raw_output,
-    const std::vector<int64_t>& out_shape,
+    const TensorView& output,
+    const LetterboxInfo& info,
+    float conf_threshold,
+    KeypointResult& result,
+    DetectionBox* box = nullptr);
+
+// Same, for image `slice` of a batched [N, ...] output from
+// YoloEngine::RunInferenceBatch. info is that image's letterbox info.
+bool YoloPostprocessSlice(
+    const TensorView& output,
+    int slice,
     const LetterboxInfo& info,
     float conf_threshold,
-    KeypointResult& result);
+    KeypointResult& result,
+    DetectionBox* box = nullptr);
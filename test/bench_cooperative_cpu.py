@@ -0,0 +1,113 @@
+"""End-to-end Analyze throughput with and without ORT thread spinning.
+Mirrors the plugin's Analyze loop: each frame is first "rendered" by a
+CPU-heavy stand-in for AE's render of a layer with expensive effects
+(a multi-pass blur over a 4K float frame, split across all cores like AE's
+render threads), then letterboxed and run through the model. ORT's pool
+threads normally spin for a while after each inference; with
+AE_YOLO_COOPERATIVE_CPU=1 the plugin turns that off, and this compares the
+two on the same loop (render only and inference only times are printed
+too, so the overlap cost is visible).
+Usage: python bench_cooperative_cpu.py <model.onnx> [frames] [render_passes] [threads]
+  render_passes  blur passes per frame, i.e. how heavy the upstream effects
+                 are (default 6; 0 = no render, inference only)
+"""
+import os
+import sys
+import time
+from concurrent.futures import ThreadPoolExecutor
+
+import numpy as np
+import onnxruntime as ort
+
+
+def make_session(model_path, threads, spinning):
+    # Same settings as the plugin's shared pool on a CPU render node.
+    opts = ort.SessionOptions()
+    opts.intra_op_num_threads = threads
+    opts.graph_optimization_level = ort.GraphOptimizationLevel.ORT_ENABLE_ALL
+    opts.add_session_config_entry('session.intra_op.allow_spinning', '1' if spinning else '0')
+    opts.add_session_config_entry('session.inter_op.allow_spinning', '1' if spinning else '0')
+    return ort.InferenceSession(model_path, opts, providers=['CPUExecutionProvider'])
+
+
+class Renderer:
+    """Stand-in for AE's render: horizontal + vertical box blur passes over
+    a 3840x2160 RGBA float frame, in row bands on a thread pool (NumPy
+    releases the GIL for these array ops)."""
+
+    def __init__(self, passes, threads):
+        self.passes = passes
+        self.frame = np.random.default_rng(0).random((2160, 3840, 4), dtype=np.float32)
+        self.pool = ThreadPoolExecutor(max_workers=threads)
+        self.bands = np.array_split(np.arange(self.frame.shape[0]), threads)
+
+    def _blur_band(self, rows):
+        band = self.frame[rows[0]:rows[-1] + 1]
+        out = band.copy()
+        for _ in range(self.passes):
+            out[:, 2:-2] = (out[:, :-4] + out[:, 1:-3] + out[:, 2:-2] + out[:, 3:-1] + out[:, 4:]) * 0.2
+            out[2:-2] = (out[:-4] + out[1:-3] + out[2:-2] + out[3:-1] + out[4:]) * 0.2
+        return out
+
+    def render(self):
+        if self.passes > 0:
+            list(self.pool.map(self._blur_band, self.bands))
+        return self.frame
+
+
+def input_shape(session):
+    shape = session.get_inputs()[0].shape
+    h = shape[2] if isinstance(shape[2], int) else 640
+    w = shape[3] if isinstance(shape[3], int) else 640
+    return (1, 3, h, w)
+
+
+def analyze(session, renderer, frames):
+    """Seconds for render -> letterbox -> infer over `frames`, plus the time
+    spent in each stage."""
+    name = session.get_inputs()[0].name
+    shape = input_shape(session)
+    tensor = np.full(shape, 114.0 / 255.0, dtype=np.float32)
+    session.run(None, {name: tensor})   # warm-up, as YoloEngine does at load
+
+    render_s = infer_s = 0.0
+    t0 = time.perf_counter()
+    for _ in range(frames):
+        t = time.perf_counter()
+        frame = renderer.render()
+        render_s += time.perf_counter() - t
+        # Nearest-neighbour stand-in for LetterboxPreprocess (not timed apart).
+        step = max(1, frame.shape[1] // shape[3])
+        small = frame[::step, ::step, :3][:shape[2], :shape[3]]
+        tensor[0, :, :small.shape[0], :small.shape[1]] = small.transpose(2, 0, 1)
+        t = time.perf_counter()
+        session.run(None, {name: tensor})
+        infer_s += time.perf_counter() - t
+    return time.perf_counter() - t0, render_s, infer_s
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(__doc__)
+        sys.exit(1)
+    model_path = sys.argv[1]
+    frames = int(sys.argv[2]) if len(sys.argv) > 2 else 30
+    passes = int(sys.argv[3]) if len(sys.argv) > 3 else 6
+    threads = int(sys.argv[4]) if len(sys.argv) > 4 else (os.cpu_count() or 1)
+
+    print(f"ONNX Runtime {ort.__version__}, {threads} threads, {frames} frames, "
+          f"{passes} render passes per frame")
+    renderer = Renderer(passes, threads)
+    baseline = None
+    for label, spinning in (('spinning (default)', True), ('cooperative', False)):
+        session = make_session(model_path, threads, spinning)
+        total, render_s, infer_s = analyze(session, renderer, frames)
+        fps = frames / total
+        baseline = baseline or fps
+        print(f"  {label:19s} {fps:7.2f} fps  ({fps / baseline:.2f}x)   "
+              f"render {1000 * render_s / frames:7.1f} ms  infer {1000 * infer_s / frames:7.1f} ms")
+        del session
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,126 @@
+"""Load time and steady-state fps of the optimized-model cache vs the .onnx.
+Mirrors YoloEngine: a cache miss optimizes the .onnx offline to an ORT-format
+file and loads that; a cache hit only loads it. A session loading an ORT-format
+model runs no graph transformers, so the entry must run as fast as the .onnx
+optimized at ENABLE_ALL; the fps columns check that. CPU entries are saved at
+ENABLE_ALL (what the engine writes) and, for comparison, EXTENDED. GPU entries
+are saved at BASIC; the engine only caches them with AE_YOLO_MODEL_CACHE_GPU=1,
+which is worth turning on only where this shows fps parity.
+Usage: python bench_model_cache.py <model.onnx> [runs] [--gpu]
+"""
+import os
+import sys
+import tempfile
+import time
+
+import numpy as np
+import onnxruntime as ort
+
+LEVELS = {
+    'BASIC': ort.GraphOptimizationLevel.ORT_ENABLE_BASIC,
+    'EXTENDED': ort.GraphOptimizationLevel.ORT_ENABLE_EXTENDED,
+    'ALL': ort.GraphOptimizationLevel.ORT_ENABLE_ALL,
+}
+
+
+def providers(gpu):
+    if not gpu:
+        return ['CPUExecutionProvider']
+    for name in ('DmlExecutionProvider', 'CoreMLExecutionProvider'):
+        if name in ort.get_available_providers():
+            return [name, 'CPUExecutionProvider']
+    sys.exit('no GPU execution provider (DirectML / CoreML) in this onnxruntime build')
+
+
+def session_options(threads=4):
+    opts = ort.SessionOptions()
+    opts.intra_op_num_threads = threads
+    opts.graph_optimization_level = ort.GraphOptimizationLevel.ORT_ENABLE_ALL
+    return opts
+
+
+def load_plain(model_path, gpu):
+    """No cache: full ORT_ENABLE_ALL optimization on every load."""
+    return ort.InferenceSession(model_path, session_options(), providers=providers(gpu))
+
+
+def write_optimized(model_path, ort_path, level, gpu):
+    opts = ort.SessionOptions()
+    opts.intra_op_num_threads = 1
+    opts.graph_optimization_level = LEVELS[level]
+    opts.add_session_config_entry('session.save_model_format', 'ORT')
+    opts.optimized_model_filepath = ort_path
+    ort.InferenceSession(model_path, opts, providers=providers(gpu))
+
+
+def load_cached(ort_path, gpu):
+    opts = session_options()
+    opts.add_session_config_entry('session.load_model_format', 'ORT')
+    return ort.InferenceSession(ort_path, opts, providers=providers(gpu))
+
+
+def median_time(fn, runs):
+    times = []
+    for _ in range(runs):
+        t0 = time.perf_counter()
+        fn()
+        times.append(time.perf_counter() - t0)
+    times.sort()
+    return times[len(times) // 2]
+
+
+def zero_input(session, size=640):
+    """Letterbox-sized zero tensor for the first input (symbolic dims: batch 1, H/W size)."""
+    meta = session.get_inputs()[0]
+    shape = [d if isinstance(d, int) and d > 0 else (1 if i == 0 else size)
+             for i, d in enumerate(meta.shape)]
+    dtype = {'tensor(float16)': np.float16, 'tensor(uint8)': np.uint8}.get(meta.type, np.float32)
+    return {meta.name: np.zeros(shape, dtype=dtype)}
+
+
+def steady_fps(session, runs):
+    """Frames/s after one warm-up run, timed over at least `runs` runs and one second."""
+    feed = zero_input(session)
+    session.run(None, feed)
+    count, t0 = 0, time.perf_counter()
+    while count < runs or time.perf_counter() - t0 < 1.0:
+        session.run(None, feed)
+        count += 1
+    return count / (time.perf_counter() - t0)
+
+
+def main():
+    args = [a for a in sys.argv[1:] if a != '--gpu']
+    gpu = '--gpu' in sys.argv[1:]
+    if not args:
+        print(__doc__)
+        sys.exit(1)
+    model_path = args[0]
+    runs = int(args[1]) if len(args) > 1 else 5
+    levels = ['BASIC'] if gpu else ['ALL', 'EXTENDED']
+
+    print(f"ONNX Runtime {ort.__version__}, {providers(gpu)[0]}, {runs} runs each")
+    plain_load = median_time(lambda: load_plain(model_path, gpu), runs)
+    plain_fps = steady_fps(load_plain(model_path, gpu), runs)
+    print(f"  uncached (.onnx, ENABLE_ALL):   load {plain_load * 1000:8.1f} ms   {plain_fps:7.2f} fps")
+
+    with tempfile.TemporaryDirectory() as cache_dir:
+        for level in levels:
+            ort_path = os.path.join(cache_dir, f'model-{level}.ort')
+
+            def cold():
+                if os.path.exists(ort_path):
+                    os.remove(ort_path)
+                write_optimized(model_path, ort_path, level, gpu)
+                load_cached(ort_path, gpu)
+
+            cold_t = median_time(cold, runs)
+            warm = median_time(lambda: load_cached(ort_path, gpu), runs)
+            fps = steady_fps(load_cached(ort_path, gpu), runs)
+            print(f"  cached {level:<8} cold (optimize + save + load) {cold_t * 1000:8.1f} ms")
+            print(f"  cached {level:<8} warm:           load {warm * 1000:8.1f} ms   {fps:7.2f} fps"
+                  f"   ({plain_load / warm:.2f}x load, {fps / plain_fps:.2f}x fps vs uncached)")
+
+
+if __name__ == '__main__':
+    main()
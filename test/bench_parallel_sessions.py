@@ -0,0 +1,81 @@
+"""Throughput of K parallel CPU sessions vs one big session.
+Mirrors AE_YOLO_CPU_SESSIONS: K sessions with (threads / K) intra-op threads
+each pull frames from a shared queue, so K=1 is the single-session baseline.
+(The plugin also shares prepacked weights between the K sessions, which only
+saves memory; the Python API does not expose that.)
+Usage: python bench_parallel_sessions.py <model.onnx> [threads] [frames] [K,K,...]
+"""
+import os
+import queue
+import sys
+import threading
+import time
+
+import numpy as np
+import onnxruntime as ort
+
+
+def make_session(model_path, threads):
+    opts = ort.SessionOptions()
+    opts.intra_op_num_threads = threads
+    opts.graph_optimization_level = ort.GraphOptimizationLevel.ORT_ENABLE_ALL
+    return ort.InferenceSession(model_path, opts, providers=['CPUExecutionProvider'])
+
+
+def input_shape(session):
+    shape = session.get_inputs()[0].shape
+    h = shape[2] if isinstance(shape[2], int) else 640
+    w = shape[3] if isinstance(shape[3], int) else 640
+    return (1, 3, h, w)
+
+
+def run_k(model_path, k, threads, frames):
+    sessions = [make_session(model_path, max(1, threads // k)) for _ in range(k)]
+    name = sessions[0].get_inputs()[0].name
+    frame = np.full(input_shape(sessions[0]), 114.0 / 255.0, dtype=np.float32)
+
+    for s in sessions:  # warm-up, as YoloEngine does at load
+        s.run(None, {name: frame})
+
+    work = queue.Queue()
+    for i in range(frames):
+        work.put(i)
+
+    def worker(s):
+        while True:
+            try:
+                work.get_nowait()
+            except queue.Empty:
+                return
+            s.run(None, {name: frame})
+
+    t0 = time.perf_counter()
+    pool = [threading.Thread(target=worker, args=(s,)) for s in sessions]
+    for t in pool:
+        t.start()
+    for t in pool:
+        t.join()
+    return frames / (time.perf_counter() - t0)
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(__doc__)
+        sys.exit(1)
+    model_path = sys.argv[1]
+    threads = int(sys.argv[2]) if len(sys.argv) > 2 else (os.cpu_count() or 1)
+    frames = int(sys.argv[3]) if len(sys.argv) > 3 else 64
+    ks = [int(k) for k in sys.argv[4].split(',')] if len(sys.argv) > 4 else [1, 2, 4, 8]
+
+    print(f"ONNX Runtime {ort.__version__}, {threads} threads, {frames} frames")
+    baseline = None
+    for k in ks:
+        if k > threads:
+            continue
+        fps = run_k(model_path, k, threads, frames)
+        baseline = baseline or fps
+        print(f"  K={k:2d} x {max(1, threads // k):2d} threads: {fps:7.2f} fps  ({fps / baseline:.2f}x)")
+
+
+if __name__ == '__main__':
+    main()
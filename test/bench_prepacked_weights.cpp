@@ -0,0 +1,111 @@
+// Memory and load time of N sessions of one model, with and without a shared
+// prepacked-weights container (YoloEngine passes one container to every CPU
+// session it creates). Sessions are created one after another with the
+// plugin's CPU settings; after each one the load time and the growth of the
+// process's resident (Windows: private) memory are printed, so the cost of
+// the first session and of each extra one can be read off directly.
+// Run each mode in its own process, since freed memory is not returned to the
+// OS and would skew the second mode:
+//   bench_prepacked_weights <model.onnx> separate [sessions] [threads]
+//   bench_prepacked_weights <model.onnx> shared   [sessions] [threads]
+// sessions defaults to 4, threads (intra-op per session) to 4.
+
+#include "onnxruntime_cxx_api.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#else
+#include <fstream>
+#include <string>
+#endif
+
+// Current process memory in bytes: private commit on Windows, resident set
+// elsewhere.
+static size_t ProcessMemoryBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS_EX counters = {};
+    GetProcessMemoryInfo(GetCurrentProcess(),
+                         reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters));
+    return counters.PrivateUsage;
+#elif defined(__APPLE__)
+    mach_task_basic_info info = {};
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count);
+    return info.resident_size;
+#else
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmRSS:") == 0) return std::strtoull(line.c_str() + 6, nullptr, 10) * 1024;
+    }
+    return 0;
+#endif
+}
+
+struct ContainerDeleter {
+    void operator()(OrtPrepackedWeightsContainer* c) const {
+        Ort::GetApi().ReleasePrepackedWeightsContainer(c);
+    }
+};
+
+int main(int argc, char** argv) {
+    if (argc < 3 || (std::strcmp(argv[2], "shared") != 0 && std::strcmp(argv[2], "separate") != 0)) {
+        std::fprintf(stderr, "Usage: bench_prepacked_weights <model.onnx> separate|shared [sessions] [threads]\n");
+        return 1;
+    }
+    const std::filesystem::path model = std::filesystem::u8path(argv[1]);
+    const bool shared = std::strcmp(argv[2], "shared") == 0;
+    const int sessions = argc > 3 ? std::max(1, std::atoi(argv[3])) : 4;
+    const int threads  = argc > 4 ? std::max(1, std::atoi(argv[4])) : 4;
+
+    Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "bench_prepacked_weights");
+    Ort::SessionOptions options;
+    options.SetIntraOpNumThreads(threads);
+    options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+
+    std::unique_ptr<OrtPrepackedWeightsContainer, ContainerDeleter> container;
+    if (shared) {
+        OrtPrepackedWeightsContainer* raw = nullptr;
+        Ort::ThrowOnError(Ort::GetApi().CreatePrepackedWeightsContainer(&raw));
+        container.reset(raw);
+    }
+
+    std::printf("ONNX Runtime %s, %s prepacked weights, %d sessions x %d threads\n",
+                Ort::GetVersionString().c_str(), shared ? "shared" : "separate", sessions, threads);
+    std::vector<std::unique_ptr<Ort::Session>> loaded;
+    const size_t base = ProcessMemoryBytes();
+    size_t previous = base;
+    double total_ms = 0.0;
+    for (int i = 0; i < sessions; i++) {
+        auto t0 = std::chrono::steady_clock::now();
+        if (container)
+            loaded.push_back(std::make_unique<Ort::Session>(env, model.c_str(), options, container.get()));
+        else
+            loaded.push_back(std::make_unique<Ort::Session>(env, model.c_str(), options));
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        total_ms += ms;
+        size_t now = ProcessMemoryBytes();
+        std::printf("  session %d: load %7.1f ms   memory %+7.1f MB (total %+7.1f MB)\n", i + 1, ms,
+                    (static_cast<double>(now) - previous) / (1 << 20),
+                    (static_cast<double>(now) - base) / (1 << 20));
+        previous = now;
+    }
+    std::printf("  all %d: load %.1f ms, memory %+.1f MB\n", sessions, total_ms,
+                (static_cast<double>(previous) - base) / (1 << 20));
+    return 0;
+}
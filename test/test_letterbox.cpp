@@ -0,0 +1,576 @@
+// Standalone test for Letterbox preprocessing.
+// Checks every SIMD kernel available on this CPU against the scalar reference
+// (bit-exact — all paths run the same Q14 integer math), verifies the padding
+// bands, and compares against the original two-pass float implementation
+// (HWC scratch + transpose) within a small tolerance. The area filter is
+// checked against a float box-filter reference. 16-bpc and 32-bpc float
+// sources are checked against the 8-bit path on the same content,
+// rectangular inputs against the square input they trim, and FP16 / uint8
+// HWC output against the float output narrowed element by element.
+// Usage: test_letterbox   (exit code 0 = pass)
+
+#include "Letterbox.h"
+
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+static int g_failures = 0;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { std::printf("FAIL: " __VA_ARGS__); std::printf("\n"); g_failures++; } \
+} while (0)
+
+// Random ARGB frame with row padding so rowbytes != width * 4.
+static std::vector<unsigned char> MakeFrame(int h, int rowbytes, uint32_t seed) {
+    std::vector<unsigned char> px(static_cast<size_t>(rowbytes) * h);
+    std::mt19937 rng(seed);
+    for (auto& b : px) b = static_cast<unsigned char>(rng() & 0xFF);
+    return px;
+}
+
+// The pre-SIMD implementation, kept verbatim as a regression reference.
+static void LegacyLetterbox(const unsigned char* argb, int width, int height, int rowbytes,
+                            int target_size, std::vector<float>& out) {
+    float scale = std::min(static_cast<float>(target_size) / width,
+                           static_cast<float>(target_size) / height);
+    int new_w = static_cast<int>(std::round(width * scale));
+    int new_h = static_cast<int>(std::round(height * scale));
+    int pad_left = (target_size - new_w) / 2;
+    int pad_top  = (target_size - new_h) / 2;
+    size_t total = static_cast<size_t>(target_size) * target_size;
+    std::vector<float> hwc(total * 3, 114.0f / 255.0f);
+    for (int y = 0; y < new_h; y++) {
+        float src_y = y / scale;
+        int sy0 = static_cast<int>(src_y);
+        int sy1 = std::min(sy0 + 1, height - 1);
+        float fy = src_y - sy0;
+        for (int x = 0; x < new_w; x++) {
+            float src_x = x / scale;
+            int sx0 = static_cast<int>(src_x);
+            int sx1 = std::min(sx0 + 1, width - 1);
+            float fx = src_x - sx0;
+            const unsigned char* p00 = argb + sy0 * rowbytes + sx0 * 4;
+            const unsigned char* p01 = argb + sy0 * rowbytes + sx1 * 4;
+            const unsigned char* p10 = argb + sy1 * rowbytes + sx0 * 4;
+            const unsigned char* p11 = argb + sy1 * rowbytes + sx1 * 4;
+            for (int c = 0; c < 3; c++) {
+                float v00 = p00[c + 1] / 255.0f, v01 = p01[c + 1] / 255.0f;
+                float v10 = p10[c + 1] / 255.0f, v11 = p11[c + 1] / 255.0f;
+                hwc[((pad_top + y) * target_size + pad_left + x) * 3 + c] =
+                    v00 * (1 - fx) * (1 - fy) + v01 * fx * (1 - fy) +
+                    v10 * (1 - fx) * fy + v11 * fx * fy;
+            }
+        }
+    }
+    out.resize(total * 3);
+    for (size_t px = 0; px < total; px++)
+        for (int c = 0; c < 3; c++)
+            out[c * total + px] = hwc[px * 3 + c];
+}
+
+static float MaxAbsDiff(const std::vector<float>& a, const std::vector<float>& b) {
+    if (a.size() != b.size()) return INFINITY;
+    float m = 0.0f;
+    for (size_t i = 0; i < a.size(); i++) m = std::max(m, std::fabs(a[i] - b[i]));
+    return m;
+}
+
+static const char* KernelName(LetterboxKernel k) {
+    switch (k) {
+        case LetterboxKernel::Scalar: return "Scalar";
+        case LetterboxKernel::SSE41:  return "SSE41";
+        case LetterboxKernel::AVX2:   return "AVX2";
+        case LetterboxKernel::NEON:   return "NEON";
+        default:                      return "Auto";
+    }
+}
+
+// Padding bands must be exactly 114/255 and content must be in [0,1].
+static bool CheckBands(const std::vector<float>& out, const LetterboxPlan& plan, const char* what) {
+    int target = plan.target_w;
+    size_t total = static_cast<size_t>(plan.target_w) * plan.target_h;
+    const float pad_value = 114.0f / 255.0f;
+    for (int c = 0; c < 3; c++) {
+        for (int y = 0; y < plan.target_h; y++) {
+            for (int x = 0; x < plan.target_w; x++) {
+                float v = out[c * total + static_cast<size_t>(y) * target + x];
+                bool inside = x >= plan.pad_left && x < plan.pad_left + plan.new_w &&
+                              y >= plan.pad_top && y < plan.pad_top + plan.new_h;
+                if (inside ? (v < 0.0f || v > 1.0f) : (v != pad_value)) {
+                    CHECK(false, "%dx%d->%d %s %s c=%d (%d,%d) = %f", plan.src_w, plan.src_h,
+                          target, what, inside ? "range" : "pad", c, x, y, v);
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+static void TestGeometry(int w, int h, int target, uint32_t seed) {
+    int rowbytes = w * 4 + 16;
+    auto frame = MakeFrame(h, rowbytes, seed);
+    LetterboxPlan plan = BuildLetterboxPlan(w, h, rowbytes, target, LetterboxFilter::Bilinear);
+
+    std::vector<float> ref;
+    LetterboxInfo ref_info = LetterboxPreprocess(plan, frame.data(), ref, LetterboxKernel::Scalar);
+    if (!CheckBands(ref, plan, "bilinear")) return;
+
+    // Every supported SIMD kernel vs scalar reference.
+    const LetterboxKernel kernels[] = {
+        LetterboxKernel::SSE41, LetterboxKernel::AVX2, LetterboxKernel::NEON, LetterboxKernel::Auto };
+    for (LetterboxKernel k : kernels) {
+        if (!LetterboxKernelSupported(k)) continue;
+        std::vector<float> out(7, -1.0f);   // wrong size on purpose: must be resized
+        LetterboxInfo info = LetterboxPreprocess(plan, frame.data(), out, k);
+        CHECK(info.scale == ref_info.scale && info.pad_x == ref_info.pad_x &&
+              info.pad_y == ref_info.pad_y, "%dx%d->%d %s info mismatch", w, h, target, KernelName(k));
+        float d = MaxAbsDiff(out, ref);
+        CHECK(d == 0.0f, "%dx%d->%d %s vs Scalar not bit-exact, max diff %g",
+              w, h, target, KernelName(k), d);
+    }
+
+    // Scalar reference vs the original two-pass float implementation. Q14
+    // weights and the Q8 intermediate round slightly differently, and a source
+    // index can land one ulp to the other side of a pixel boundary; allow well
+    // under one 8-bit step.
+    std::vector<float> legacy;
+    LegacyLetterbox(frame.data(), w, h, rowbytes, target, legacy);
+    float d = MaxAbsDiff(legacy, ref);
+    CHECK(d <= 1e-3f, "%dx%d->%d Scalar vs legacy max diff %g", w, h, target, d);
+}
+
+// Straightforward float box filter used to check both area paths.
+static void ReferenceArea(const unsigned char* argb, const LetterboxPlan& plan, std::vector<float>& out) {
+    int target = plan.target_w;
+    size_t total = static_cast<size_t>(plan.target_w) * plan.target_h;
+    out.assign(total * 3, 114.0f / 255.0f);
+    double inv = 1.0 / plan.info.scale;
+    for (int y = 0; y < plan.new_h; y++) {
+        double y0 = y * inv, y1 = std::min((y + 1) * inv, static_cast<double>(plan.src_h));
+        for (int x = 0; x < plan.new_w; x++) {
+            double x0 = x * inv, x1 = std::min((x + 1) * inv, static_cast<double>(plan.src_w));
+            double sum[3] = { 0, 0, 0 }, area = 0;
+            for (int sy = static_cast<int>(y0); sy < y1; sy++) {
+                double cy = std::min(sy + 1.0, y1) - std::max(static_cast<double>(sy), y0);
+                for (int sx = static_cast<int>(x0); sx < x1; sx++) {
+                    double cx = std::min(sx + 1.0, x1) - std::max(static_cast<double>(sx), x0);
+                    const unsigned char* p = argb + static_cast<size_t>(sy) * plan.rowbytes + sx * 4;
+                    for (int c = 0; c < 3; c++) sum[c] += p[c + 1] * cx * cy;
+                    area += cx * cy;
+                }
+            }
+            for (int c = 0; c < 3; c++)
+                out[c * total + static_cast<size_t>(plan.pad_top + y) * target + plan.pad_left + x] =
+                    static_cast<float>(sum[c] / area / 255.0);
+        }
+    }
+}
+
+static void TestArea(int w, int h, int target, int expect_ratio, uint32_t seed) {
+    int rowbytes = w * 4;
+    auto frame = MakeFrame(h, rowbytes, seed);
+    LetterboxPlan plan = BuildLetterboxPlan(w, h, rowbytes, target);
+    CHECK(plan.filter == LetterboxFilter::Area, "%dx%d->%d did not auto-select Area", w, h, target);
+    CHECK(plan.area_ratio == expect_ratio, "%dx%d->%d area ratio %d, expected %d",
+          w, h, target, plan.area_ratio, expect_ratio);
+
+    std::vector<float> out, ref;
+    LetterboxPreprocess(plan, frame.data(), out);
+    if (!CheckBands(out, plan, "area")) return;
+    ReferenceArea(frame.data(), plan, ref);
+    float d = MaxAbsDiff(out, ref);
+    CHECK(d <= 1e-3f, "%dx%d->%d area (ratio %d) vs reference max diff %g", w, h, target, plan.area_ratio, d);
+
+    // The general tap path must agree with the integer fast path.
+    if (plan.area_ratio) {
+        LetterboxPlan general = plan;
+        general.area_ratio = 0;
+        std::vector<float> out_general;
+        LetterboxPreprocess(general, frame.data(), out_general);
+        d = MaxAbsDiff(out, out_general);
+        CHECK(d <= 1e-3f, "%dx%d->%d area fast path vs general max diff %g", w, h, target, d);
+    }
+
+    // Banding must not change the result.
+    std::vector<float> single;
+    LetterboxPreprocess(plan, frame.data(), single, LetterboxKernel::Auto, 1);
+    CHECK(MaxAbsDiff(out, single) == 0.0f, "%dx%d->%d area banded differs from single", w, h, target);
+}
+
+// Same content as an 8-bit frame, widened to AE 16-bpc (0..32768) and 32-bpc
+// float (0..1) layouts with the same row padding in pixels.
+template <typename Channel>
+static std::vector<Channel> WidenFrame(const std::vector<unsigned char>& frame8, float range) {
+    std::vector<Channel> out(frame8.size());
+    for (size_t i = 0; i < frame8.size(); i++) {
+        float v = frame8[i] * (range / 255.0f);
+        out[i] = range > 1.0f ? static_cast<Channel>(std::lround(v)) : static_cast<Channel>(v);
+    }
+    return out;
+}
+
+template <typename Channel>
+static void TestDepth(const char* name, int w, int h, int target, LetterboxFilter filter, uint32_t seed) {
+    int row_px = w + 4;
+    auto frame8 = MakeFrame(h, row_px * 4, seed);
+    auto frame = WidenFrame<Channel>(frame8, std::is_same<Channel, float>::value ? 1.0f : 32768.0f);
+    int rowbytes = row_px * 4 * static_cast<int>(sizeof(Channel));
+
+    LetterboxPlan plan8 = BuildLetterboxPlan(w, h, row_px * 4, target, filter);
+    LetterboxPlan plan  = BuildLetterboxPlan(w, h, rowbytes, target, filter);
+    std::vector<float> ref8, ref;
+    LetterboxPreprocess(plan8, frame8.data(), ref8, LetterboxKernel::Scalar);
+    LetterboxPreprocess(plan, frame.data(), ref, LetterboxKernel::Scalar);
+    if (!CheckBands(ref, plan, name)) return;
+
+    // 8-bit rounds its horizontal pass to Q8; the wide paths do not.
+    float d = MaxAbsDiff(ref, ref8);
+    CHECK(d <= 1e-3f, "%s %dx%d->%d vs 8-bit max diff %g", name, w, h, target, d);
+
+    const LetterboxKernel kernels[] = {
+        LetterboxKernel::SSE41, LetterboxKernel::AVX2, LetterboxKernel::NEON, LetterboxKernel::Auto };
+    for (LetterboxKernel k : kernels) {
+        if (!LetterboxKernelSupported(k)) continue;
+        std::vector<float> out;
+        LetterboxPreprocess(plan, frame.data(), out, k, 1);
+        d = MaxAbsDiff(out, ref);
+        CHECK(d <= 1e-6f, "%s %dx%d->%d %s vs Scalar max diff %g", name, w, h, target, KernelName(k), d);
+    }
+}
+
+int main() {
+    const LetterboxKernel kernels[] = {
+        LetterboxKernel::SSE41, LetterboxKernel::AVX2, LetterboxKernel::NEON };
+    for (LetterboxKernel k : kernels)
+        std::printf("kernel %-6s %s\n", KernelName(k),
+                    LetterboxKernelSupported(k) ? "supported" : "n/a");
+
+    struct { int w, h, target; } cases[] = {
+        { 3840, 2160, 640 },    // UHD landscape
+        { 2960, 3840, 640 },    // tall portrait plate
+        { 1920, 1080, 640 },
+        { 1917, 1079, 640 },    // odd sizes exercise SIMD tails
+        { 640,  640,  640 },    // identity scale
+        { 320,  180,  640 },    // upscale
+        { 33,   7,    64 },
+        { 1,    1,    32 },
+    };
+    uint32_t seed = 1;
+    for (auto& c : cases) TestGeometry(c.w, c.h, c.target, seed++);
+
+    // Area filter: auto-selected below 0.5x, exact k×k box when divisible.
+    struct { int w, h, target, ratio; } area_cases[] = {
+        { 3840, 2160, 640, 6 },
+        { 2880, 3840, 640, 6 },
+        { 2960, 3840, 640, 0 },     // 2960 not divisible by 6: general taps
+        { 1920, 1080, 640, 3 },
+        { 2560, 1440, 640, 4 },
+        { 1280, 720,  320, 4 },
+        { 4096, 2160, 640, 0 },     // 6.4x: general taps
+        { 1917, 1079, 300, 0 },
+    };
+    for (auto& c : area_cases) TestArea(c.w, c.h, c.target, c.ratio, seed++);
+    CHECK(BuildLetterboxPlan(1280, 720, 1280 * 4, 640).filter == LetterboxFilter::Bilinear,
+          "exactly 0.5x should stay bilinear");
+    CHECK(BuildLetterboxPlan(3840, 2160, 3840 * 4, 640, LetterboxFilter::Bilinear).filter ==
+          LetterboxFilter::Bilinear, "explicit Bilinear must not be overridden");
+
+    // 16-bpc and 32-bpc float sources (bilinear and both area paths).
+    struct { int w, h, target; LetterboxFilter filter; } depth_cases[] = {
+        { 1917, 1079, 640, LetterboxFilter::Bilinear },
+        { 33,   7,    64,  LetterboxFilter::Bilinear },
+        { 1920, 1080, 640, LetterboxFilter::Area },     // 3×3 box
+        { 1917, 1079, 300, LetterboxFilter::Area },     // general taps
+    };
+    for (auto& c : depth_cases) {
+        TestDepth<uint16_t>("16bpc", c.w, c.h, c.target, c.filter, seed);
+        TestDepth<float>("32bpc", c.w, c.h, c.target, c.filter, seed++);
+    }
+
+    // Float sources outside [0,1] clamp after filtering. NaN maps to 0 too, but
+    // only without fast-math (the plugin itself is built with it).
+    {
+        int w = 64, h = 64, rb = w * 4 * static_cast<int>(sizeof(float));
+        const float fills[][2] = {
+            { 4.0f, 1.0f }, { -0.5f, 0.0f },
+#if !defined(__FAST_MATH__)
+            { NAN, 0.0f },
+#endif
+        };
+        for (auto& fill : fills) {
+            std::vector<float> frame(static_cast<size_t>(w) * h * 4, fill[0]);
+            for (LetterboxFilter filter : { LetterboxFilter::Bilinear, LetterboxFilter::Area }) {
+                LetterboxPlan plan = BuildLetterboxPlan(w, h, rb, filter == LetterboxFilter::Area ? 16 : 48, filter);
+                std::vector<float> out;
+                LetterboxPreprocess(plan, frame.data(), out);
+                size_t centre = static_cast<size_t>(plan.target_h / 2) * plan.target_w + plan.target_w / 2;
+                CHECK(out[centre] == fill[1], "float fill %g maps to %g, expected %g", fill[0], out[centre], fill[1]);
+            }
+        }
+    }
+
+    // Reusing one plan and output buffer across frames must give identical
+    // results to the one-shot overload.
+    {
+        int w = 1280, h = 720, rb = w * 4;
+        auto a = MakeFrame(h, rb, 100), b = MakeFrame(h, rb, 200);
+        LetterboxPlan plan = BuildLetterboxPlan(w, h, rb, 640);
+        CHECK(plan.Matches(w, h, rb, 640) && !plan.Matches(w, h, rb + 4, 640), "plan Matches");
+        std::vector<float> buf, fresh;
+        LetterboxPreprocess(plan, a.data(), buf);
+        LetterboxPreprocess(plan, b.data(), buf);
+        LetterboxPreprocess(b.data(), w, h, rb, 640, fresh);
+        CHECK(MaxAbsDiff(buf, fresh) == 0.0f, "reused plan/buffer differs from fresh buffer");
+    }
+
+    // Row bands on the worker pool must match a single-threaded run exactly,
+    // including when several threads preprocess at once.
+    {
+        int w = 3840, h = 2160, rb = w * 4;
+        auto frame = MakeFrame(h, rb, 300);
+        LetterboxPlan plan = BuildLetterboxPlan(w, h, rb, 640);
+        std::vector<float> single, banded;
+        LetterboxPreprocess(plan, frame.data(), single, LetterboxKernel::Auto, 1);
+        for (int threads : { 0, 2, 3, 7, 64 }) {
+            LetterboxPreprocess(plan, frame.data(), banded, LetterboxKernel::Auto, threads);
+            CHECK(MaxAbsDiff(single, banded) == 0.0f, "threads=%d differs from single-threaded", threads);
+        }
+
+        std::vector<std::vector<float>> outs(4);
+        std::vector<std::thread> callers;
+        for (auto& out : outs)
+            callers.emplace_back([&] { LetterboxPreprocess(plan, frame.data(), out); });
+        for (auto& t : callers) t.join();
+        for (auto& out : outs)
+            CHECK(MaxAbsDiff(single, out) == 0.0f, "concurrent caller differs from single-threaded");
+    }
+
+    // Extremes of the fixed-point range map exactly to 0 and 1.
+    {
+        int w = 97, h = 61, rb = w * 4;
+        std::vector<unsigned char> white(static_cast<size_t>(rb) * h, 255), black(white.size(), 0);
+        std::vector<float> out;
+        LetterboxInfo info = LetterboxPreprocess(white.data(), w, h, rb, 64, out);
+        size_t centre = static_cast<size_t>(info.pad_y + 5) * 64 + 32;
+        CHECK(out[centre] == 1.0f, "white maps to %f", out[centre]);
+        LetterboxPreprocess(black.data(), w, h, rb, 64, out);
+        CHECK(out[centre] == 0.0f, "black maps to %f", out[centre]);
+    }
+
+    // Render downsample factor: largest integer that keeps the long side at or
+    // above the model input, and remapping from the downsampled frame lands on
+    // the same full-res coordinate as remapping from a full-res frame.
+    {
+        CHECK(LetterboxDownsampleFactor(3840, 2160, 640) == 6, "4K factor");
+        CHECK(LetterboxDownsampleFactor(2160, 3840, 640) == 6, "portrait 4K factor");
+        CHECK(LetterboxDownsampleFactor(1920, 1080, 640) == 3, "HD factor");
+        CHECK(LetterboxDownsampleFactor(1279, 720, 640) == 1, "just under 2x");
+        CHECK(LetterboxDownsampleFactor(320, 240, 640) == 1, "upscale");
+        CHECK(LetterboxDownsampleFactor(0, 0, 640) == 1, "unknown source size");
+
+        int factor = LetterboxDownsampleFactor(3840, 2160, 640);
+        LetterboxPlan full = BuildLetterboxPlan(3840, 2160, 3840 * 4, 640);
+        LetterboxPlan down = BuildLetterboxPlan(3840 / factor, 2160 / factor, 3840 / factor * 4, 640);
+        LetterboxInfo info = LetterboxToFullRes(down.info, factor, 3840, 2160);
+        CHECK(info.orig_w == 3840 && info.orig_h == 2160, "full-res size not restored");
+        const float probes[][2] = { { 0, 140 }, { 320, 320 }, { 639, 499 }, { 17.5f, 260.25f } };
+        for (auto& p : probes) {
+            float fx, fy, dx, dy;
+            LetterboxRemap(full.info, p[0], p[1], fx, fy);
+            LetterboxRemap(info, p[0], p[1], dx, dy);
+            CHECK(std::fabs(fx - dx) < 1e-2f && std::fabs(fy - dy) < 1e-2f,
+                  "remap (%g,%g): full-res (%g,%g) vs downsampled (%g,%g)", p[0], p[1], fx, fy, dx, dy);
+        }
+        LetterboxInfo same = LetterboxToFullRes(full.info, 1, 0, 0);
+        CHECK(same.scale == full.info.scale && same.orig_w == 3840, "factor 1 must be a no-op");
+    }
+
+    // Tracking crop: letterboxing a crop must remap to the same frame
+    // coordinates as the pixels it came from, and the crop rectangle must be
+    // square, quantized and inside the frame.
+    {
+        LetterboxCropRect crop;
+        CHECK(LetterboxCropAround(1800, 500, 2000, 900, 0.5f, 3840, 2160, 32, crop), "crop rejected");
+        CHECK(crop.w == 800 && crop.h == 800, "crop size %dx%d", crop.w, crop.h);
+        CHECK(crop.x == 1500 && crop.y == 300, "crop origin %d,%d", crop.x, crop.y);
+        CHECK(LetterboxCropAround(3700, 2000, 3830, 2150, 0.5f, 3840, 2160, 32, crop) &&
+              crop.x + crop.w <= 3840 && crop.y + crop.h <= 2160, "crop not clamped to frame");
+        CHECK(!LetterboxCropAround(100, 100, 1900, 1000, 0.5f, 1920, 1080, 32, crop),
+              "crop covering most of the frame should fall back");
+        CHECK(!LetterboxCropAround(10, 10, 10, 50, 0.5f, 1920, 1080, 32, crop), "empty box accepted");
+
+        // Put a single bright pixel in a frame and find it through a crop.
+        int w = 1920, h = 1080, rb = w * 4;
+        std::vector<unsigned char> frame(static_cast<size_t>(rb) * h, 0);
+        const int px = 1000, py = 600;
+        for (int c = 1; c < 4; c++) frame[static_cast<size_t>(py) * rb + px * 4 + c] = 255;
+        LetterboxCropAround(950, 500, 1050, 700, 0.5f, w, h, 32, crop);
+        LetterboxPlan plan = BuildLetterboxPlan(crop.w, crop.h, rb, 640);
+        std::vector<float> out;
+        LetterboxInfo info = LetterboxPreprocess(
+            plan, frame.data() + static_cast<size_t>(crop.y) * rb + crop.x * 4, out);
+        info = LetterboxToCrop(info, crop, w, h);
+        size_t best = 0;
+        for (size_t i = 0; i < 640 * 640; i++) if (out[i] > out[best]) best = i;
+        float fx, fy;
+        LetterboxRemap(info, static_cast<float>(best % 640), static_cast<float>(best / 640), fx, fy);
+        CHECK(std::fabs(fx - px) <= 1.0f && std::fabs(fy - py) <= 1.0f,
+              "crop remap found (%g,%g), expected (%d,%d)", fx, fy, px, py);
+
+        // Crop offsets scale with the render downsample factor.
+        LetterboxInfo full = LetterboxToFullRes(info, 3, w * 3, h * 3);
+        CHECK(full.crop_x == crop.x * 3.0f && full.crop_y == crop.y * 3.0f, "crop offset not scaled");
+    }
+
+    // Rectangular input for dynamic-shape models: the smallest stride-aligned
+    // shape that holds the frame, with the same content as the square input
+    // and only the padding bands trimmed.
+    {
+        int iw, ih;
+        LetterboxInputShape(1920, 1080, 640, 32, iw, ih);
+        CHECK(iw == 640 && ih == 384, "16:9 input shape %dx%d", iw, ih);
+        LetterboxInputShape(2160, 3840, 640, 32, iw, ih);
+        CHECK(iw == 384 && ih == 640, "9:16 input shape %dx%d", iw, ih);
+        LetterboxInputShape(1000, 1000, 640, 32, iw, ih);
+        CHECK(iw == 640 && ih == 640, "square input shape %dx%d", iw, ih);
+        LetterboxInputShape(4000, 10, 640, 32, iw, ih);
+        CHECK(iw == 640 && ih == 32, "sliver input shape %dx%d", iw, ih);
+        LetterboxInputShape(0, 0, 640, 32, iw, ih);
+        CHECK(iw == 640 && ih == 640, "unknown source shape %dx%d", iw, ih);
+
+        struct { int w, h; LetterboxFilter filter; } rect_cases[] = {
+            { 1920, 1080, LetterboxFilter::Bilinear },
+            { 1917, 1079, LetterboxFilter::Bilinear },
+            { 3840, 2160, LetterboxFilter::Area },
+            { 1080, 1920, LetterboxFilter::Area },
+        };
+        for (auto& c : rect_cases) {
+            int rb = c.w * 4 + 16;
+            auto frame = MakeFrame(c.h, rb, seed++);
+            LetterboxInputShape(c.w, c.h, 640, 32, iw, ih);
+            LetterboxPlan square = BuildLetterboxPlan(c.w, c.h, rb, 640, c.filter);
+            LetterboxPlan rect = BuildLetterboxPlan(c.w, c.h, rb, iw, ih, c.filter);
+            CHECK(rect.Matches(c.w, c.h, rb, iw, ih) && !rect.Matches(c.w, c.h, rb, 640),
+                  "%dx%d rect plan Matches", c.w, c.h);
+            CHECK(rect.info.scale == square.info.scale && rect.new_w == square.new_w &&
+                  rect.new_h == square.new_h, "%dx%d rect scale differs from square", c.w, c.h);
+            CHECK(rect.info.input_w == iw && rect.info.input_h == ih, "%dx%d rect info size", c.w, c.h);
+
+            std::vector<float> sq_out, rect_out;
+            LetterboxPreprocess(square, frame.data(), sq_out);
+            LetterboxPreprocess(rect, frame.data(), rect_out);
+            CHECK(rect_out.size() == static_cast<size_t>(3) * iw * ih, "%dx%d rect output size", c.w, c.h);
+            if (!CheckBands(rect_out, rect, "rect")) continue;
+
+            // Same content pixels, and the same frame point for each of them.
+            size_t sq_total = static_cast<size_t>(640) * 640, rect_total = static_cast<size_t>(iw) * ih;
+            float d = 0.0f;
+            for (int ch = 0; ch < 3; ch++)
+                for (int y = 0; y < rect.new_h; y++)
+                    for (int x = 0; x < rect.new_w; x++)
+                        d = std::max(d, std::fabs(
+                            sq_out[ch * sq_total + static_cast<size_t>(square.pad_top + y) * 640 + square.pad_left + x] -
+                            rect_out[ch * rect_total + static_cast<size_t>(rect.pad_top + y) * iw + rect.pad_left + x]));
+            CHECK(d == 0.0f, "%dx%d rect content differs from square, max diff %g", c.w, c.h, d);
+
+            float sx, sy, rx, ry;
+            LetterboxRemap(square.info, square.pad_left + 100.0f, square.pad_top + 50.0f, sx, sy);
+            LetterboxRemap(rect.info, rect.pad_left + 100.0f, rect.pad_top + 50.0f, rx, ry);
+            CHECK(sx == rx && sy == ry, "%dx%d rect remap (%g,%g) vs square (%g,%g)", c.w, c.h, rx, ry, sx, sy);
+        }
+    }
+
+    // ---- FP16 output: every element is the float output narrowed once ----
+    {
+        struct { int w, h, size; LetterboxFilter filter; } half_cases[] = {
+            { 1920, 1080, 640, LetterboxFilter::Bilinear },
+            { 1280,  720, 640, LetterboxFilter::Area },      // general taps
+            { 3840, 2160, 640, LetterboxFilter::Area },      // exact box
+            {  333,  517, 320, LetterboxFilter::Bilinear },  // band tail < chunk
+        };
+        for (auto& c : half_cases) {
+            int rb = c.w * 4 + 16;
+            auto frame = MakeFrame(c.h, rb, seed++);
+            int iw, ih;
+            LetterboxInputShape(c.w, c.h, c.size, 32, iw, ih);
+            LetterboxPlan plan = BuildLetterboxPlan(c.w, c.h, rb, iw, ih, c.filter);
+
+            std::vector<float> ref;
+            std::vector<Float16> half, half_single;
+            LetterboxPreprocess(plan, frame.data(), ref);
+            LetterboxPreprocess(plan, frame.data(), half);
+            LetterboxPreprocess(plan, frame.data(), half_single, LetterboxKernel::Auto, 1);
+            CHECK(half.size() == ref.size(), "%dx%d fp16 output size", c.w, c.h);
+            if (half.size() != ref.size()) continue;
+
+            size_t mismatches = 0;
+            for (size_t i = 0; i < ref.size(); i++)
+                if (half[i].val != Float16(ref[i]).val || half_single[i].val != half[i].val) mismatches++;
+            CHECK(mismatches == 0, "%dx%d fp16: %zu element(s) differ from narrowed float",
+                  c.w, c.h, mismatches);
+            CHECK(std::fabs(half[0].ToFloat() - 114.0f / 255.0f) < 1e-3f, "%dx%d fp16 pad value %g",
+                  c.w, c.h, half[0].ToFloat());
+        }
+
+        // 16-bpc source through the half path.
+        const int w = 1000, h = 600, rb = w * 8;
+        std::vector<uint16_t> frame16(static_cast<size_t>(w) * h * 4);
+        std::mt19937 rng(seed++);
+        for (auto& v : frame16) v = static_cast<uint16_t>(rng() % 32769);
+        LetterboxPlan plan = BuildLetterboxPlan(w, h, rb, 640);
+        std::vector<float> ref;
+        std::vector<Float16> half;
+        LetterboxPreprocess(plan, frame16.data(), ref);
+        LetterboxPreprocess(plan, frame16.data(), half);
+        size_t mismatches = 0;
+        for (size_t i = 0; i < ref.size(); i++)
+            if (half[i].val != Float16(ref[i]).val) mismatches++;
+        CHECK(mismatches == 0, "16-bpc fp16: %zu element(s) differ from narrowed float", mismatches);
+    }
+
+    // ---- uint8 HWC output: float output rounded to bytes, interleaved ----
+    {
+        struct { int w, h; LetterboxFilter filter; int threads; } rgb_cases[] = {
+            { 1920, 1080, LetterboxFilter::Bilinear, 0 },
+            { 1280,  720, LetterboxFilter::Area,     0 },
+            {  333,  517, LetterboxFilter::Bilinear, 1 },
+        };
+        for (auto& c : rgb_cases) {
+            int rb = c.w * 4 + 16;
+            auto frame = MakeFrame(c.h, rb, seed++);
+            int iw, ih;
+            LetterboxInputShape(c.w, c.h, 640, 32, iw, ih);
+            LetterboxPlan plan = BuildLetterboxPlan(c.w, c.h, rb, iw, ih, c.filter);
+
+            std::vector<float> ref;
+            std::vector<unsigned char> hwc;
+            LetterboxPreprocess(plan, frame.data(), ref);
+            LetterboxPreprocessRGB8(plan, frame.data(), hwc, LetterboxKernel::Auto, c.threads);
+            size_t total = static_cast<size_t>(iw) * ih;
+            CHECK(hwc.size() == total * 3, "%dx%d rgb8 output size", c.w, c.h);
+            if (hwc.size() != total * 3) continue;
+
+            size_t mismatches = 0;
+            for (size_t i = 0; i < total; i++)
+                for (int ch = 0; ch < 3; ch++) {
+                    int expect = static_cast<int>(ref[ch * total + i] * 255.0f + 0.5f);
+                    if (hwc[i * 3 + ch] != expect) mismatches++;
+                }
+            CHECK(mismatches == 0, "%dx%d rgb8: %zu byte(s) differ from rounded float", c.w, c.h, mismatches);
+            CHECK(hwc[0] == 114 && hwc[total * 3 - 1] == 114, "%dx%d rgb8 pad bytes", c.w, c.h);
+        }
+    }
+
+    if (g_failures) {
+        std::printf("%d failure(s)\n", g_failures);
+        return 1;
+    }
+    std::printf("All letterbox tests passed\n");
+    return 0;
+}
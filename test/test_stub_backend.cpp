@@ -0,0 +1,321 @@
+// Standalone test for StubBackend, and a load test of the analysis pipeline
+// on top of it with no model file and no ONNX Runtime.
+// Checks the synthetic output shapes ([1, 56, anchors] and [1, N, 57]) at
+// square and rectangular inputs, that the detection follows the subject and
+// is identical on the zero-copy, copying and batched paths, that fixed-shape
+// options are enforced, and that the simulated latency is paid per run and
+// per image and is interrupted by RequestCancel. The pipeline part renders
+// synthetic 1080p frames with a moving subject, letterboxes them, runs them
+// through the stub in batches, decodes them with YoloPostprocessSlice,
+// smooths the nose track and checks it against the subject, printing the
+// frame rate (pass a latency to see how batching and the loop overhead
+// behave at a given model speed). Detections are always decoded by the
+// plugin's own YoloPostprocess, so this needs the AE SDK headers.
+// Usage: test_stub_backend [frames] [latency_ms per frame]   (exit code 0 = pass)
+
+#include "Letterbox.h"
+#include "SavGolSmooth.h"
+#include "StubBackend.h"
+#include "YoloPostprocess.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <thread>
+#include <vector>
+
+static int g_failures = 0;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { std::printf("FAIL: " __VA_ARGS__); std::printf("\n"); g_failures++; } \
+} while (0)
+
+static const char* FormatName(StubOutputFormat format) {
+    return format == StubOutputFormat::PostNms ? "post-NMS" : "raw";
+}
+
+static double ElapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Letterbox-gray CHW input with a white w x h block centred at (cx, cy).
+static std::vector<float> MakeInput(int width, int height, int cx, int cy, int w, int h) {
+    const size_t plane = static_cast<size_t>(width) * height;
+    std::vector<float> chw(plane * 3, 114.0f / 255.0f);
+    for (int y = std::max(0, cy - h / 2); y < std::min(height, cy + h / 2); y++)
+        for (int x = std::max(0, cx - w / 2); x < std::min(width, cx + w / 2); x++)
+            for (int c = 0; c < 3; c++) chw[c * plane + static_cast<size_t>(y) * width + x] = 1.0f;
+    return chw;
+}
+
+// Image `slice` of a stub output decoded the way the plugin decodes a model's,
+// through YoloPostprocessSlice; keypoints come back in the frame described
+// by info.
+static bool Decode(const std::vector<float>& out, const std::vector<int64_t>& shape, int slice,
+                   const LetterboxInfo& info, KeypointResult& result) {
+    return YoloPostprocessSlice(TensorView::Of(out, shape), slice, info, 0.25f, result);
+}
+
+// No letterbox: the frame is the model input, so keypoints stay in model
+// input pixels (clamped to the input, as LetterboxRemap clamps to a frame).
+static LetterboxInfo IdentityInfo(int width, int height) {
+    return LetterboxInfo{ 1.0f, 0.0f, 0.0f, width, height, width, height, 0.0f, 0.0f };
+}
+
+static void TestShapes(StubOutputFormat format) {
+    StubBackendOptions options;
+    options.format = format;
+    StubBackend stub(options);
+    CHECK(!stub.IsReady() && stub.GetInputSize() == 0, "%s: ready before EnsureSession", FormatName(format));
+    stub.EnsureSession("no-such-model.onnx", true);
+    CHECK(stub.IsReady() && stub.GetInputWidth() == 640 && stub.GetInputHeight() == 640,
+          "%s: default input", FormatName(format));
+
+    struct { int w, h; int64_t anchors; } cases[] = {
+        { 640, 640, 8400 }, { 640, 384, 5040 }, { 320, 320, 2100 },
+    };
+    for (auto& c : cases) {
+        CHECK(stub.SetInputShape(c.w, c.h), "%s: SetInputShape %dx%d", FormatName(format), c.w, c.h);
+        std::vector<float> input(static_cast<size_t>(3) * c.w * c.h, 114.0f / 255.0f), out;
+        std::vector<int64_t> shape;
+        CHECK(stub.RunInference(input.data(), 0, out, shape), "%s: run %dx%d", FormatName(format), c.w, c.h);
+        std::vector<int64_t> expect = format == StubOutputFormat::PostNms
+            ? std::vector<int64_t>{ 1, 300, 57 } : std::vector<int64_t>{ 1, 56, c.anchors };
+        CHECK(shape == expect && out.size() == static_cast<size_t>(expect[1] * expect[2]),
+              "%s %dx%d: shape [%lld, %lld, %lld]", FormatName(format), c.w, c.h,
+              static_cast<long long>(shape.size() == 3 ? shape[0] : -1),
+              static_cast<long long>(shape.size() == 3 ? shape[1] : -1),
+              static_cast<long long>(shape.size() == 3 ? shape[2] : -1));
+    }
+}
+
+// The person sits on the subject, the same on every path, and batches stack.
+static void TestDetection(StubOutputFormat format) {
+    StubBackendOptions options;
+    options.format = format;
+    StubBackend stub(options);
+    stub.EnsureSession("model.onnx", false);
+    const int w = 640, h = 384;
+    stub.SetInputShape(w, h);
+
+    const int centres[][2] = { { 320, 192 }, { 100, 150 }, { 560, 300 } };
+    std::vector<std::vector<float>> inputs;
+    std::vector<const float*> ptrs;
+    for (auto& c : centres) inputs.push_back(MakeInput(w, h, c[0], c[1], 40, 120));
+    for (auto& in : inputs) ptrs.push_back(in.data());
+
+    std::vector<float> batch_out;
+    std::vector<int64_t> batch_shape;
+    CHECK(stub.RunInferenceBatch(ptrs.data(), 3, batch_out, batch_shape) && batch_shape[0] == 3,
+          "%s: batch of 3", FormatName(format));
+
+    for (int i = 0; i < 3; i++) {
+        std::vector<float> out;
+        std::vector<int64_t> shape;
+        CHECK(stub.RunInference(inputs[i].data(), 0, out, shape), "%s: copying run", FormatName(format));
+
+        stub.InputBuffer() = inputs[i];
+        TensorView view;
+        CHECK(stub.RunInference(view) && view.Count() == out.size() &&
+              std::equal(out.begin(), out.end(), view.As<float>()),
+              "%s: zero-copy output differs from copying output", FormatName(format));
+        CHECK(std::equal(out.begin(), out.end(), batch_out.begin() + out.size() * i),
+              "%s: batch slice %d differs from single run", FormatName(format), i);
+
+        float cx = 0, cy = 0;
+        StubBackend::SubjectCentre(inputs[i].data(), w, h, cx, cy);
+        CHECK(std::fabs(cx - centres[i][0]) < 1.0f && std::fabs(cy - centres[i][1]) < 1.0f,
+              "%s: subject centre %.1f,%.1f, expected %d,%d", FormatName(format), cx, cy,
+              centres[i][0], centres[i][1]);
+        const float bh = StubBackend::SubjectHeight(w, h);
+        KeypointResult kp = {};
+        const bool found = Decode(out, shape, 0, IdentityInfo(w, h), kp);
+        CHECK(found, "%s: no person decoded at %d,%d", FormatName(format), centres[i][0], centres[i][1]);
+        for (int k : { 0, 9, 16 }) {
+            const float ex = std::min(std::max(cx + StubBackend::kSkeleton[k][0] * bh * 0.5f, 0.0f), w - 1.0f);
+            const float ey = std::min(std::max(cy + StubBackend::kSkeleton[k][1] * bh, 0.0f), h - 1.0f);
+            CHECK(!found || (std::fabs(kp.x[k] - ex) < 1e-3f && std::fabs(kp.y[k] - ey) < 1e-3f),
+                  "%s: keypoint %d at %.1f,%.1f, expected %.1f,%.1f", FormatName(format), k,
+                  kp.x[k], kp.y[k], ex, ey);
+        }
+    }
+
+    // No subject: one person in the middle.
+    std::vector<float> flat(static_cast<size_t>(3) * w * h, 114.0f / 255.0f), out;
+    std::vector<int64_t> shape;
+    KeypointResult kp = {};
+    CHECK(stub.RunInference(flat.data(), 0, out, shape) && Decode(out, shape, 0, IdentityInfo(w, h), kp) &&
+          std::fabs(kp.x[0] - w * 0.5f) < 1e-3f, "%s: flat frame nose at %.1f", FormatName(format), kp.x[0]);
+}
+
+static void TestFixedShape() {
+    StubBackendOptions options;
+    options.dynamic_input = false;
+    options.dynamic_batch = false;
+    options.input_size = 512;
+    StubBackend stub(options);
+    stub.EnsureSession("fixed.onnx", true, 640);
+    CHECK(stub.GetInputSize() == 512 && !stub.HasDynamicInputSize() && !stub.HasDynamicBatch(),
+          "fixed: input size %d", stub.GetInputSize());
+    CHECK(!stub.SetInputShape(512, 288) && stub.SetInputShape(512, 512), "fixed: SetInputShape");
+    CHECK(stub.PreferredBatchSize() == 1, "fixed: preferred batch %d", stub.PreferredBatchSize());
+    std::vector<float> input(static_cast<size_t>(3) * 320 * 320), out;
+    std::vector<int64_t> shape;
+    CHECK(!stub.RunInference(input.data(), 320, out, shape), "fixed: ran at another size");
+}
+
+static void TestLatencyAndCancel() {
+    StubBackendOptions options;
+    options.run_latency_ms = 10.0;
+    options.image_latency_ms = 20.0;
+    StubBackend stub(options);
+    stub.EnsureSession("slow.onnx", false);
+    const size_t size = static_cast<size_t>(3) * 640 * 640;
+    std::vector<float> a(size, 0.5f), b(size, 0.25f), out;
+    std::vector<int64_t> shape;
+    const float* ptrs[] = { a.data(), b.data(), a.data(), b.data() };
+
+    auto start = std::chrono::steady_clock::now();
+    CHECK(stub.RunInferenceBatch(ptrs, 4, out, shape), "latency: batch run");
+    double ms = ElapsedMs(start);
+    CHECK(ms >= 90.0 && ms < 1000.0, "latency: batch of 4 took %.1f ms, expected 90", ms);
+
+    StubBackendOptions looped_options = options;
+    looped_options.dynamic_batch = false;
+    StubBackend looped(looped_options);
+    looped.EnsureSession("slow.onnx", false);
+    start = std::chrono::steady_clock::now();
+    CHECK(looped.RunInferenceBatch(ptrs, 4, out, shape), "latency: looped batch run");
+    ms = ElapsedMs(start);
+    CHECK(ms >= 120.0 && ms < 1000.0, "latency: looped batch of 4 took %.1f ms, expected 120", ms);
+
+    // Cancel from another thread, as the Analyze poll does, stops the wait.
+    StubBackendOptions slow_options;
+    slow_options.image_latency_ms = 5000.0;
+    StubBackend slow(slow_options);
+    slow.EnsureSession("slow.onnx", false);
+    start = std::chrono::steady_clock::now();
+    auto task = std::async(std::launch::async, [&] { return slow.RunInference(a.data(), 0, out, shape); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    slow.RequestCancel();
+    CHECK(!task.get(), "cancel: run reported success");
+    ms = ElapsedMs(start);
+    CHECK(ms < 1000.0, "cancel: took %.1f ms", ms);
+    CHECK(!slow.RunInference(a.data(), 0, out, shape), "cancel: ran before ResetCancel");
+    slow.ResetCancel();
+    slow_options.image_latency_ms = 0.0;
+    StubBackend fast(slow_options);
+    fast.EnsureSession("fast.onnx", false);
+    CHECK(fast.RunInference(a.data(), 0, out, shape), "cancel: fresh backend cannot run");
+}
+
+// Analyze-style loop: render a 1080p ARGB frame with the subject, letterbox
+// it at the dynamic input shape, batch, run, read the nose, then smooth the
+// track. Returns the nose x track in source pixels (smoothed).
+static std::vector<float> RunPipeline(StubOutputFormat format, int frames, double latency_ms,
+                                      double& fps, float& max_error) {
+    const int src_w = 1920, src_h = 1080, rowbytes = src_w * 4;
+    const int subject_w = 160, subject_h = 480;
+    StubBackendOptions options;
+    options.format = format;
+    options.image_latency_ms = latency_ms;
+    StubBackend stub(options);
+    BackendPin pin(stub);
+    stub.EnsureSession("pipeline.onnx", false);
+    int input_w = 0, input_h = 0;
+    LetterboxInputShape(src_w, src_h, stub.GetInputSize(), 32, input_w, input_h);
+    stub.SetInputShape(input_w, input_h);
+    const int batch_size = stub.PreferredBatchSize();
+
+    LetterboxPlan plan = BuildLetterboxPlan(src_w, src_h, rowbytes, input_w, input_h);
+    std::vector<unsigned char> frame(static_cast<size_t>(rowbytes) * src_h);
+    std::vector<std::vector<float>> batch_inputs(batch_size);
+    std::vector<const float*> batch_ptrs(batch_size);
+    std::vector<LetterboxInfo> batch_info(batch_size);
+    std::vector<float> nose_x(frames), nose_y(frames), conf(frames, 0.9f), subject_x(frames);
+    std::vector<bool> valid(frames, false);
+    std::vector<float> raw_output;
+    std::vector<int64_t> out_shape;
+
+    auto start = std::chrono::steady_clock::now();
+    int queued = 0;
+    auto flush = [&](int last) {
+        if (queued == 0) return;
+        for (int i = 0; i < queued; i++) batch_ptrs[i] = batch_inputs[i].data();
+        bool ok = stub.RunInferenceBatch(batch_ptrs.data(), queued, raw_output, out_shape);
+        CHECK(ok, "pipeline: batch run failed");
+        for (int i = 0; ok && i < queued; i++) {
+            int f = last - queued + 1 + i;
+            KeypointResult kp = {};
+            if (Decode(raw_output, out_shape, i, batch_info[i], kp)) {
+                nose_x[f] = kp.x[0];
+                nose_y[f] = kp.y[0];
+                valid[f] = true;
+            }
+        }
+        queued = 0;
+    };
+    for (int f = 0; f < frames; f++) {
+        // Subject walks across the frame on a gray background.
+        subject_x[f] = 300.0f + 1300.0f * f / std::max(1, frames - 1);
+        const int sx0 = static_cast<int>(subject_x[f]) - subject_w / 2, sy0 = 540 - subject_h / 2;
+        for (int y = 0; y < src_h; y++) {
+            unsigned char* row = frame.data() + static_cast<size_t>(y) * rowbytes;
+            for (int x = 0; x < src_w; x++) {
+                const bool on = x >= sx0 && x < sx0 + subject_w && y >= sy0 && y < sy0 + subject_h;
+                row[x * 4] = 255;
+                row[x * 4 + 1] = row[x * 4 + 2] = row[x * 4 + 3] = on ? 255 : 114;
+            }
+        }
+        batch_info[queued] = LetterboxPreprocess(plan, frame.data(), batch_inputs[queued]);
+        if (f == frames - 1) stub.SetArenaShrinkage(true);
+        if (++queued == batch_size) flush(f);
+    }
+    flush(frames - 1);
+    stub.SetArenaShrinkage(false);
+    SavGol::SmoothKeypoints(nose_x, nose_y, conf, valid, 5, 2);
+    fps = frames * 1000.0 / ElapsedMs(start);
+
+    // The mirrored boundary of the smoother bends a steady walk in the first
+    // and last half-window, so those frames are left out of the error.
+    max_error = 0.0f;
+    for (int f = 0; f < frames; f++) {
+        CHECK(valid[f], "pipeline %s: frame %d has no detection", FormatName(format), f);
+        if (f >= 2 && f < frames - 2)
+            max_error = std::max(max_error, std::fabs(nose_x[f] - subject_x[f]));
+    }
+    return nose_x;
+}
+
+int main(int argc, char** argv) {
+    const int frames = argc > 1 ? std::max(8, std::atoi(argv[1])) : 96;
+    const double latency_ms = argc > 2 ? std::max(0.0, std::atof(argv[2])) : 0.0;
+
+    for (StubOutputFormat format : { StubOutputFormat::RawAnchors, StubOutputFormat::PostNms }) {
+        TestShapes(format);
+        TestDetection(format);
+    }
+    TestFixedShape();
+    TestLatencyAndCancel();
+
+    for (StubOutputFormat format : { StubOutputFormat::RawAnchors, StubOutputFormat::PostNms }) {
+        double fps = 0.0, fps_again = 0.0;
+        float error = 0.0f, error_again = 0.0f;
+        std::vector<float> track = RunPipeline(format, frames, latency_ms, fps, error);
+        std::vector<float> again = RunPipeline(format, frames, latency_ms, fps_again, error_again);
+        CHECK(track == again, "pipeline %s: two runs differ", FormatName(format));
+        CHECK(error < 1.5f, "pipeline %s: nose is %.2f px off the subject", FormatName(format), error);
+        std::printf("pipeline %-8s %d frames, %.1f ms/frame simulated: %7.1f fps, max nose error %.2f px\n",
+                    FormatName(format), frames, latency_ms, fps, error);
+    }
+
+    if (g_failures) {
+        std::printf("%d failure(s)\n", g_failures);
+        return 1;
+    }
+    std::printf("All stub backend tests passed\n");
+    return 0;
+}
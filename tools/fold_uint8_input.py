@@ -0,0 +1,134 @@
+"""Fold input normalization into a pose model so it takes uint8 RGB.
+Rewrites a model with a float [N, 3, H, W] input in 0..1 to take
+uint8 [N, H, W, 3] RGB bytes instead, with Cast -> Div(255) -> Transpose
+prepended inside the graph. The plugin detects such models and letterboxes
+straight into bytes (LetterboxPreprocessRGB8): the input tensor is a quarter
+of the size and the CPU skips the divide and the CHW transpose.
+
+When the normalized input feeds a single Conv with constant weights (every
+YOLO export), the Div is folded into that Conv instead: its weights are
+divided by 255, leaving only Cast -> Transpose in front of it.
+
+Usage: python fold_uint8_input.py <model.onnx> [options]
+  --out PATH    output model (default: <stem>-u8.onnx)
+  --keep-div    keep the Div node instead of folding it into the first Conv
+  --check       compare outputs against the original on a random frame
+"""
+import argparse
+import os
+import sys
+
+import numpy as np
+import onnx
+from onnx import TensorProto, helper, numpy_helper
+
+
+def copy_dim(dim, target):
+    if dim.HasField('dim_value'):
+        target.dim_value = dim.dim_value
+    elif dim.HasField('dim_param'):
+        target.dim_param = dim.dim_param
+
+
+def fold_into_conv(graph, tensor):
+    """Scale the weights of the one Conv reading `tensor` by 1/255.
+    Returns False when that is not a safe rewrite."""
+    consumers = [n for n in graph.node if tensor in n.input]
+    if len(consumers) != 1 or consumers[0].op_type != 'Conv' or consumers[0].input[0] != tensor:
+        return False
+    weight_name = consumers[0].input[1]
+    if sum(weight_name in n.input for n in graph.node) != 1:
+        return False   # shared weights would be scaled for other nodes too
+    for i, init in enumerate(graph.initializer):
+        if init.name == weight_name:
+            weights = numpy_helper.to_array(init)
+            scaled = (weights.astype(np.float64) / 255.0).astype(weights.dtype)
+            graph.initializer[i].CopyFrom(numpy_helper.from_array(scaled, weight_name))
+            return True
+    return False
+
+
+def fold(model, keep_div):
+    graph = model.graph
+    inp = graph.input[0]
+    tensor_type = inp.type.tensor_type
+    elem = tensor_type.elem_type
+    dims = tensor_type.shape.dim
+    if elem not in (TensorProto.FLOAT, TensorProto.FLOAT16):
+        sys.exit(f"Error: input {inp.name} is not float/float16 (already folded?)")
+    if len(dims) != 4 or dims[1].dim_value != 3:
+        sys.exit(f"Error: input {inp.name} is not [N, 3, H, W]")
+
+    # The graph keeps its input name; the old consumers read the normalized copy.
+    name = inp.name
+    normalized = name + '_normalized'
+    for node in graph.node:
+        for i, value in enumerate(node.input):
+            if value == name:
+                node.input[i] = normalized
+
+    nhwc = onnx.ValueInfoProto()
+    nhwc.name = name
+    nhwc.type.tensor_type.elem_type = TensorProto.UINT8
+    shape = nhwc.type.tensor_type.shape
+    for src in (dims[0], dims[2], dims[3]):
+        copy_dim(src, shape.dim.add())
+    shape.dim.add().dim_value = 3
+    inp.CopyFrom(nhwc)
+
+    folded = not keep_div and fold_into_conv(graph, normalized)
+    cast_out = name + '_float'
+    nodes = [helper.make_node('Cast', [name], [cast_out], to=elem, name=name + '_cast')]
+    if folded:
+        transpose_in = cast_out
+    else:
+        scale = name + '_scale'
+        dtype = np.float16 if elem == TensorProto.FLOAT16 else np.float32
+        graph.initializer.append(numpy_helper.from_array(np.array(255, dtype=dtype), scale))
+        transpose_in = name + '_scaled'
+        nodes.append(helper.make_node('Div', [cast_out, scale], [transpose_in], name=name + '_div'))
+    nodes.append(helper.make_node('Transpose', [transpose_in], [normalized],
+                                  perm=[0, 3, 1, 2], name=name + '_transpose'))
+    for node in reversed(nodes):
+        graph.node.insert(0, node)
+    return folded
+
+
+def check(original, folded):
+    import onnxruntime as ort
+    a = ort.InferenceSession(original, providers=['CPUExecutionProvider'])
+    b = ort.InferenceSession(folded, providers=['CPUExecutionProvider'])
+    inp = a.get_inputs()[0]
+    h = inp.shape[2] if isinstance(inp.shape[2], int) else 640
+    w = inp.shape[3] if isinstance(inp.shape[3], int) else 640
+    frame = np.random.default_rng(0).integers(0, 256, (1, h, w, 3), dtype=np.uint8)
+    chw = frame.transpose(0, 3, 1, 2).astype(np.float32) / 255.0
+    if inp.type == 'tensor(float16)':
+        chw = chw.astype(np.float16)
+    out_a = a.run(None, {inp.name: chw})[0].astype(np.float32)
+    out_b = b.run(None, {inp.name: frame})[0].astype(np.float32)
+    print(f"  max output difference: {np.abs(out_a - out_b).max():.5f} "
+          f"(output range {out_a.min():.1f}..{out_a.max():.1f})")
+
+
+def main():
+    parser = argparse.ArgumentParser(usage=__doc__)
+    parser.add_argument('model')
+    parser.add_argument('--out')
+    parser.add_argument('--keep-div', action='store_true')
+    parser.add_argument('--check', action='store_true')
+    args = parser.parse_args()
+
+    model = onnx.load(args.model)
+    folded = fold(model, args.keep_div)
+    onnx.checker.check_model(model)
+    out_path = args.out or os.path.splitext(args.model)[0] + '-u8.onnx'
+    onnx.save(model, out_path)
+    print(f"Wrote {out_path}: uint8 [N, H, W, 3] input, "
+          + ("/255 folded into the first Conv" if folded else "Cast/Div/Transpose prepended"))
+    if args.check:
+        check(args.model, out_path)
+
+
+if __name__ == '__main__':
+    main()
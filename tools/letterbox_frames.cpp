@@ -0,0 +1,156 @@
+// Letterbox calibration frames exactly as the plugin does.
+// Reads binary PPM frames (P6, 8-bit — e.g. exported with
+//   ffmpeg -i clip.mov -vf fps=2 frames/%05d.ppm)
+// runs them through the plugin's own BuildLetterboxPlan / LetterboxPreprocess
+// and writes each result as a float32 [1, 3, H, W] .npy file, ready for
+// tools/quantize_int8.py. The plugin renders layers at the largest integer
+// downsample that still covers the model input (LetterboxDownsampleFactor);
+// frames are box-averaged by the same factor first so the calibration data
+// sees the same resampling path.
+// Usage: letterbox_frames [--size 640] [--rect] [--full-res] <out_dir> <frame.ppm>...
+//   --rect      aspect-fitted input for dynamic H/W models (LetterboxInputShape)
+//   --full-res  skip the downsample (the plugin's Full Resolution Analysis)
+
+#include "Letterbox.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Binary PPM (P6, maxval <= 255) into AE-layout ARGB 8-bit pixels.
+static bool ReadPPM(const std::string& path, int& width, int& height, std::vector<unsigned char>& argb) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::string magic;
+    in >> magic;
+    if (magic != "P6") return false;
+
+    int values[3];
+    for (int& v : values) {
+        in >> std::ws;
+        while (in.peek() == '#') {
+            std::string comment;
+            std::getline(in, comment);
+            in >> std::ws;
+        }
+        in >> v;
+    }
+    width = values[0];
+    height = values[1];
+    if (!in || width <= 0 || height <= 0 || values[2] <= 0 || values[2] > 255) return false;
+    in.get();   // single whitespace before the raster
+
+    std::vector<unsigned char> rgb(static_cast<size_t>(width) * height * 3);
+    in.read(reinterpret_cast<char*>(rgb.data()), static_cast<std::streamsize>(rgb.size()));
+    if (!in) return false;
+
+    argb.resize(static_cast<size_t>(width) * height * 4);
+    for (size_t i = 0, n = static_cast<size_t>(width) * height; i < n; i++) {
+        argb[i * 4 + 0] = 255;
+        argb[i * 4 + 1] = static_cast<unsigned char>(rgb[i * 3 + 0] * 255 / values[2]);
+        argb[i * 4 + 2] = static_cast<unsigned char>(rgb[i * 3 + 1] * 255 / values[2]);
+        argb[i * 4 + 3] = static_cast<unsigned char>(rgb[i * 3 + 2] * 255 / values[2]);
+    }
+    return true;
+}
+
+// Box-average by an integer factor, standing in for AE's downsampled render.
+static void Downsample(const std::vector<unsigned char>& src, int width, int height, int factor,
+                       std::vector<unsigned char>& dst, int& out_w, int& out_h) {
+    out_w = width / factor;
+    out_h = height / factor;
+    dst.assign(static_cast<size_t>(out_w) * out_h * 4, 0);
+    for (int y = 0; y < out_h; y++) {
+        for (int x = 0; x < out_w; x++) {
+            for (int c = 0; c < 4; c++) {
+                int sum = 0;
+                for (int dy = 0; dy < factor; dy++)
+                    for (int dx = 0; dx < factor; dx++)
+                        sum += src[(static_cast<size_t>(y * factor + dy) * width + x * factor + dx) * 4 + c];
+                dst[(static_cast<size_t>(y) * out_w + x) * 4 + c] =
+                    static_cast<unsigned char>((sum + factor * factor / 2) / (factor * factor));
+            }
+        }
+    }
+}
+
+// NumPy .npy v1.0 file holding a C-order float32 array.
+static bool WriteNpy(const std::string& path, const std::vector<float>& data, int height, int width) {
+    std::string header = "{'descr': '<f4', 'fortran_order': False, 'shape': (1, 3, " +
+                         std::to_string(height) + ", " + std::to_string(width) + "), }";
+    size_t total = 10 + header.size() + 1;
+    header.append((64 - total % 64) % 64, ' ');
+    header += '\n';
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+    const unsigned char preamble[8] = { 0x93, 'N', 'U', 'M', 'P', 'Y', 1, 0 };
+    out.write(reinterpret_cast<const char*>(preamble), sizeof(preamble));
+    const unsigned char len[2] = { static_cast<unsigned char>(header.size() & 0xFF),
+                                   static_cast<unsigned char>(header.size() >> 8) };
+    out.write(reinterpret_cast<const char*>(len), sizeof(len));
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+    out.write(reinterpret_cast<const char*>(data.data()),
+              static_cast<std::streamsize>(data.size() * sizeof(float)));
+    return static_cast<bool>(out);
+}
+
+static std::string Stem(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    size_t dot = name.rfind('.');
+    return dot == std::string::npos ? name : name.substr(0, dot);
+}
+
+int main(int argc, char** argv) {
+    int size = 640;
+    bool rect = false, full_res = false;
+    int arg = 1;
+    for (; arg < argc && std::strncmp(argv[arg], "--", 2) == 0; arg++) {
+        if (!std::strcmp(argv[arg], "--size") && arg + 1 < argc) size = std::atoi(argv[++arg]);
+        else if (!std::strcmp(argv[arg], "--rect")) rect = true;
+        else if (!std::strcmp(argv[arg], "--full-res")) full_res = true;
+        else { std::fprintf(stderr, "unknown option %s\n", argv[arg]); return 1; }
+    }
+    if (argc - arg < 2 || size <= 0) {
+        std::fprintf(stderr, "Usage: %s [--size 640] [--rect] [--full-res] <out_dir> <frame.ppm>...\n", argv[0]);
+        return 1;
+    }
+    std::string out_dir = argv[arg++];
+
+    int written = 0;
+    std::vector<unsigned char> frame, scaled;
+    std::vector<float> chw;
+    for (; arg < argc; arg++) {
+        int w = 0, h = 0;
+        if (!ReadPPM(argv[arg], w, h, frame)) {
+            std::fprintf(stderr, "skipping %s: not an 8-bit binary PPM\n", argv[arg]);
+            continue;
+        }
+
+        int factor = full_res ? 1 : LetterboxDownsampleFactor(w, h, size);
+        const std::vector<unsigned char>* pixels = &frame;
+        int fw = w, fh = h;
+        if (factor > 1) {
+            Downsample(frame, w, h, factor, scaled, fw, fh);
+            pixels = &scaled;
+        }
+
+        int input_w = size, input_h = size;
+        if (rect) LetterboxInputShape(w, h, size, 32, input_w, input_h);
+        LetterboxPlan plan = BuildLetterboxPlan(fw, fh, fw * 4, input_w, input_h);
+        LetterboxPreprocess(plan, pixels->data(), chw);
+
+        std::string out_path = out_dir + "/" + Stem(argv[arg]) + ".npy";
+        if (!WriteNpy(out_path, chw, input_h, input_w)) {
+            std::fprintf(stderr, "cannot write %s\n", out_path.c_str());
+            return 1;
+        }
+        written++;
+    }
+    std::printf("%d frame(s) written to %s\n", written, out_dir.c_str());
+    return written > 0 ? 0 : 1;
+}
@@ -0,0 +1,185 @@
+"""Static INT8 quantization of a pose model, calibrated on our own footage.
+Calibration frames come from tools/letterbox_frames, i.e. the plugin's own
+LetterboxPreprocess, so the quantizer sees exactly the tensors the plugin
+feeds the model. Writes <stem>-int8.onnx next to the FP32 model (the plugin
+offers it as "INT8 (CPU)" in Model Quality) and reports keypoint and
+confidence deltas plus CPU fps against FP32 on held-out frames.
+
+The box/keypoint decode at the end of the graph (everything between the
+last Conv and the output) stays in float by default: it mixes pixel
+coordinates and 0..1 confidences in one tensor, which a single INT8 scale
+cannot represent well.
+
+Usage: python quantize_int8.py <model.onnx> <npy_dir> [options]
+  --out PATH           output model (default: <stem>-int8.onnx)
+  --format qdq|qoperator
+  --method minmax|entropy|percentile
+  --holdout F          share of frames kept out of calibration for the report (0.2)
+  --reduce-range       7-bit weights; avoids U8S8 saturation on AVX2 without VNNI
+  --quantize-head      quantize the decode head too
+  --threads N          intra-op threads for the fps comparison (default: all)
+"""
+import argparse
+import glob
+import os
+import sys
+import tempfile
+import time
+
+import numpy as np
+import onnx
+import onnxruntime as ort
+from onnxruntime.quantization import (CalibrationDataReader, CalibrationMethod, QuantFormat,
+                                      QuantType, quantize_static)
+
+
+class FrameReader(CalibrationDataReader):
+    """Feeds one letterboxed .npy frame per calibration step."""
+
+    def __init__(self, files, input_name):
+        self.files = files
+        self.input_name = input_name
+        self.rewind()
+
+    def get_next(self):
+        path = next(self.iter, None)
+        return None if path is None else {self.input_name: np.load(path)}
+
+    def rewind(self):
+        self.iter = iter(self.files)
+
+
+def head_nodes(model):
+    """Nodes between the last Conv layers and the graph outputs."""
+    producer = {out: node for node in model.graph.node for out in node.output}
+    seen, names, stack = set(), set(), [o.name for o in model.graph.output]
+    while stack:
+        node = producer.get(stack.pop())
+        if node is None or id(node) in seen or node.op_type == 'Conv':
+            continue
+        seen.add(id(node))
+        if node.name:
+            names.add(node.name)
+        stack.extend(node.input)
+    return sorted(names)
+
+
+def make_session(model_path, threads):
+    # Same INT8 options YoloEngine sets for quantized models.
+    opts = ort.SessionOptions()
+    opts.intra_op_num_threads = threads
+    opts.graph_optimization_level = ort.GraphOptimizationLevel.ORT_ENABLE_ALL
+    opts.add_session_config_entry('session.qdqisint8allowed', '1')
+    return ort.InferenceSession(model_path, opts, providers=['CPUExecutionProvider'])
+
+
+def best_person(output, conf_threshold=0.25):
+    """(conf, [17, 3] keypoints in model space) of the top detection, or None.
+    Handles both output layouts, as YoloPostprocess does."""
+    data = output[0]
+    dim1, dim2 = data.shape
+    if dim2 == 57 or (56 <= dim2 <= 60 and dim1 <= 1000):     # post-NMS [N, 57]
+        best = int(np.argmax(data[:, 4]))
+        conf, kps = data[best, 4], data[best, 6:6 + 51]
+    else:                                                        # raw anchors [56, M]
+        best = int(np.argmax(data[4]))
+        conf, kps = data[4, best], data[5:5 + 51, best]
+    return None if conf < conf_threshold else (float(conf), kps.reshape(17, 3))
+
+
+def compare(fp32_path, int8_path, files, threads):
+    fp32 = make_session(fp32_path, threads)
+    int8 = make_session(int8_path, threads)
+    name = fp32.get_inputs()[0].name
+
+    kp_dist, kp_conf, box_conf = [], [], []
+    agree = 0
+    for path in files:
+        frame = np.load(path)
+        a = best_person(fp32.run(None, {name: frame})[0])
+        b = best_person(int8.run(None, {name: frame})[0])
+        agree += (a is None) == (b is None)
+        if a and b:
+            box_conf.append(abs(a[0] - b[0]))
+            kp_dist.append(np.hypot(*(a[1][:, :2] - b[1][:, :2]).T).mean())
+            kp_conf.append(np.abs(a[1][:, 2] - b[1][:, 2]).mean())
+
+    print(f"  detection agreement:     {agree}/{len(files)} frames")
+    if kp_dist:
+        print(f"  keypoint error:          {np.mean(kp_dist):6.2f} px mean, "
+              f"{np.percentile(kp_dist, 95):6.2f} px p95 (model input space)")
+        print(f"  keypoint conf delta:     {np.mean(kp_conf):6.4f} mean")
+        print(f"  box conf delta:          {np.mean(box_conf):6.4f} mean")
+
+    frame = np.load(files[0])
+    for label, sess in (('FP32', fp32), ('INT8', int8)):
+        sess.run(None, {name: frame})   # warm-up
+        runs = max(5, min(50, len(files)))
+        t0 = time.perf_counter()
+        for _ in range(runs):
+            sess.run(None, {name: frame})
+        fps = runs / (time.perf_counter() - t0)
+        if label == 'FP32':
+            base = fps
+        print(f"  {label} CPU throughput:    {fps:7.2f} fps  ({fps / base:.2f}x)")
+
+
+def main():
+    parser = argparse.ArgumentParser(usage=__doc__)
+    parser.add_argument('model')
+    parser.add_argument('npy_dir')
+    parser.add_argument('--out')
+    parser.add_argument('--format', choices=['qdq', 'qoperator'], default='qdq')
+    parser.add_argument('--method', choices=['minmax', 'entropy', 'percentile'], default='minmax')
+    parser.add_argument('--holdout', type=float, default=0.2)
+    parser.add_argument('--reduce-range', action='store_true')
+    parser.add_argument('--quantize-head', action='store_true')
+    parser.add_argument('--threads', type=int, default=os.cpu_count() or 1)
+    args = parser.parse_args()
+
+    files = sorted(glob.glob(os.path.join(args.npy_dir, '*.npy')))
+    if not files:
+        print(f"Error: no .npy frames in {args.npy_dir} (run letterbox_frames first)")
+        sys.exit(1)
+    step = max(2, round(1.0 / args.holdout)) if args.holdout > 0 else 0
+    held_out = files[::step] if step and len(files) > 1 else files
+    calib = [f for f in files if f not in held_out] or files
+
+    out_path = args.out or os.path.splitext(args.model)[0] + '-int8.onnx'
+    print(f"ONNX Runtime {ort.__version__}: {len(calib)} calibration / {len(held_out)} held-out frames")
+
+    with tempfile.TemporaryDirectory() as tmp:
+        # Shape inference + basic fusions first, as the quantizer recommends.
+        source = args.model
+        try:
+            from onnxruntime.quantization.shape_inference import quant_pre_process
+            source = os.path.join(tmp, 'pre.onnx')
+            quant_pre_process(args.model, source)
+        except Exception as e:
+            print(f"  pre-processing skipped: {e}")
+            source = args.model
+
+        model = onnx.load(source)
+        input_name = model.graph.input[0].name
+        exclude = [] if args.quantize_head else head_nodes(model)
+        print(f"  {len(exclude)} decode-head nodes kept in float")
+
+        quantize_static(
+            source, out_path, FrameReader(calib, input_name),
+            quant_format=QuantFormat.QDQ if args.format == 'qdq' else QuantFormat.QOperator,
+            per_channel=True,
+            reduce_range=args.reduce_range,
+            activation_type=QuantType.QUInt8,
+            weight_type=QuantType.QInt8,
+            nodes_to_exclude=exclude,
+            calibrate_method={'minmax': CalibrationMethod.MinMax,
+                              'entropy': CalibrationMethod.Entropy,
+                              'percentile': CalibrationMethod.Percentile}[args.method])
+
+    size = os.path.getsize(args.model) / 2**20, os.path.getsize(out_path) / 2**20
+    print(f"Wrote {out_path} ({size[0]:.1f} MB -> {size[1]:.1f} MB)")
+    compare(args.model, out_path, held_out, args.threads)
+
+
+if __name__ == '__main__':
+    main()